@@ -0,0 +1,202 @@
+/************************************************************************************
+ * Copyright (c) 2025, xeus-cpp contributors                                        *
+ *                                                                                  *
+ * Distributed under the terms of the BSD 3-Clause License.                         *
+ *                                                                                  *
+ * The full license is in the file LICENSE, distributed with this software.         *
+ ************************************************************************************/
+
+#ifndef XCPP_BINARY_HPP
+#define XCPP_BINARY_HPP
+
+#include <cstddef>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <numeric>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#if __cplusplus >= 202002L
+#include <span>
+#endif
+
+#include <nlohmann/json.hpp>
+
+#include "xeus/xcomm.hpp"
+#include "xeus/xguid.hpp"
+#include "xeus/xinterpreter.hpp"
+
+#include "xeus-cpp/xiopub.hpp"
+
+namespace nl = nlohmann;
+
+namespace xcpp
+{
+    // Arrays displayed with display_binary() are sent as the binary buffer
+    // of a comm opened on this target. The display data only references the
+    // comm, so that the frontend receives the bytes as they are in memory
+    // instead of a text rendering of every element. xeus-cpp does not ship
+    // the frontend extension: without one registering this target, the
+    // frontend closes the comm and the bytes are dropped.
+    constexpr const char* binary_comm_target = "xcpp.array";
+    constexpr const char* binary_mime_type = "application/vnd.xcpp.array+json";
+
+    // Type string of the elements in the numpy array interface format,
+    // e.g. "<f8" for a little-endian double.
+    template <class T>
+    std::string dtype()
+    {
+        static_assert(std::is_arithmetic_v<T>, "binary display requires arithmetic elements");
+        std::string res;
+#if defined(__BYTE_ORDER__) && defined(__ORDER_BIG_ENDIAN__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+        res += sizeof(T) == 1 ? '|' : '>';
+#else
+        res += sizeof(T) == 1 ? '|' : '<';
+#endif
+        if constexpr (std::is_same_v<T, bool>)
+        {
+            res += 'b';
+        }
+        else if constexpr (std::is_floating_point_v<T>)
+        {
+            res += 'f';
+        }
+        else if constexpr (std::is_signed_v<T>)
+        {
+            res += 'i';
+        }
+        else
+        {
+            res += 'u';
+        }
+        res += std::to_string(sizeof(T));
+        return res;
+    }
+
+    struct binary_bundle
+    {
+        // Description of the array: dtype, shape and size in bytes.
+        nl::json data;
+        xeus::buffer_sequence buffers;
+    };
+
+    // Copies `data`, a contiguous array in row-major order, into a single
+    // binary buffer. The buffer type of xeus owns its memory, this copy is the
+    // only one made before the message is sent.
+    template <class T>
+    binary_bundle binary_repr(const T* data, std::vector<std::size_t> shape)
+    {
+        const std::size_t size = std::accumulate(
+            shape.begin(),
+            shape.end(),
+            std::size_t(1),
+            std::multiplies<std::size_t>()
+        );
+        const std::size_t nbytes = size * sizeof(T);
+
+        binary_bundle res;
+        res.data = {{"dtype", dtype<T>()}, {"shape", std::move(shape)}, {"nbytes", nbytes}};
+        xeus::binary_buffer buffer(nbytes);
+        if (nbytes != 0)
+        {
+            std::memcpy(buffer.data(), data, nbytes);
+        }
+        res.buffers.push_back(std::move(buffer));
+        return res;
+    }
+
+    template <class T>
+    std::string binary_summary(const nl::json& data)
+    {
+        std::string res = "<array of ";
+        if constexpr (std::is_same_v<T, bool>)
+        {
+            res += "bool";
+        }
+        else
+        {
+            res += std::is_floating_point_v<T> ? "float" : std::is_signed_v<T> ? "int" : "uint";
+            res += std::to_string(8 * sizeof(T));
+        }
+        res += ", shape (";
+        const auto& shape = data["shape"];
+        for (std::size_t i = 0; i < shape.size(); ++i)
+        {
+            res += (i == 0 ? "" : ", ") + std::to_string(shape[i].get<std::size_t>());
+        }
+        res += shape.size() == 1 ? ",)>" : ")>";
+        return res;
+    }
+
+    namespace detail
+    {
+        inline xeus::xtarget* binary_target()
+        {
+            // The frontend does not open comms on this target, the callback
+            // only makes it known to the comm manager.
+            static xeus::xtarget* target = []
+            {
+                auto& manager = xeus::get_interpreter().comm_manager();
+                manager.register_comm_target(
+                    binary_comm_target,
+                    [](xeus::xcomm&&, const xeus::xmessage&)
+                    {
+                    }
+                );
+                return manager.target(binary_comm_target);
+            }();
+            return target;
+        }
+    }
+
+    // Displays a contiguous array of numbers as raw bytes. The output holds
+    // a binary_mime_type entry with the dtype, the shape and the id of the
+    // comm carrying the bytes, for renderers that handle it, and a one-line
+    // summary as text/plain for the others, which is all that is shown
+    // without a renderer. The kernel does not keep the data once sent.
+    template <class T>
+    void display_binary(const T* data, std::vector<std::size_t> shape)
+    {
+        binary_bundle bundle = binary_repr(data, std::move(shape));
+        // Shared with the publisher, which may be held until the next cell
+        // when called from another thread.
+        auto comm = std::make_shared<xeus::xcomm>(detail::binary_target(), xeus::new_xguid());
+
+        nl::json mime = bundle.data;
+        mime["comm_id"] = comm->id();
+        nl::json display = {{binary_mime_type, std::move(mime)}, {"text/plain", binary_summary<T>(bundle.data)}};
+
+        publish_serialized(
+            [comm, bundle = std::move(bundle), display = std::move(display)]() mutable
+            {
+                comm->open(nl::json::object(), std::move(bundle.data), std::move(bundle.buffers));
+                xeus::get_interpreter().display_data(std::move(display), nl::json::object(), nl::json::object());
+            }
+        );
+    }
+
+    template <class T>
+    void display_binary(const T* data, std::size_t size)
+    {
+        display_binary(data, std::vector<std::size_t>{size});
+    }
+
+    template <class T, class A>
+    void display_binary(const std::vector<T, A>& data)
+    {
+        display_binary(data.data(), data.size());
+    }
+
+#if __cplusplus >= 202002L
+    template <class T, std::size_t N>
+    void display_binary(std::span<T, N> data)
+    {
+        display_binary(static_cast<const std::remove_cv_t<T>*>(data.data()), data.size());
+    }
+#endif
+}
+
+#endif
@@ -10,12 +10,18 @@
 #ifndef XCPP_DISPLAY_HPP
 #define XCPP_DISPLAY_HPP
 
+#include <utility>
+
 #include <nlohmann/json.hpp>
 
+#include "xcpp/xbinary.hpp"
 #include "xcpp/xmime.hpp"
+#include "xcpp/xthrottled_display.hpp"
 
 #include "xeus/xinterpreter.hpp"
 
+#include "xeus-cpp/xiopub.hpp"
+
 namespace nl = nlohmann;
 
 namespace xcpp
@@ -34,7 +40,13 @@ namespace xcpp
     void display(const T& t)
     {
         using ::xcpp::mime_bundle_repr;
-        xeus::get_interpreter().display_data(mime_bundle_repr(t), nl::json::object(), nl::json::object());
+        nl::json bundle = mime_bundle_repr(t);
+        publish_serialized(
+            [bundle = std::move(bundle)]() mutable
+            {
+                xeus::get_interpreter().display_data(std::move(bundle), nl::json::object(), nl::json::object());
+            }
+        );
     }
 
     template <class T>
@@ -43,20 +55,31 @@ namespace xcpp
         nl::json transient;
         transient["display_id"] = id;
         using ::xcpp::mime_bundle_repr;
-        if (update)
-        {
-            xeus::get_interpreter()
-                .update_display_data(mime_bundle_repr(t), nl::json::object(), std::move(transient));
-        }
-        else
-        {
-            xeus::get_interpreter().display_data(mime_bundle_repr(t), nl::json::object(), std::move(transient));
-        }
+        nl::json bundle = mime_bundle_repr(t);
+        publish_serialized(
+            [bundle = std::move(bundle), transient = std::move(transient), update]() mutable
+            {
+                if (update)
+                {
+                    xeus::get_interpreter()
+                        .update_display_data(std::move(bundle), nl::json::object(), std::move(transient));
+                }
+                else
+                {
+                    xeus::get_interpreter().display_data(std::move(bundle), nl::json::object(), std::move(transient));
+                }
+            }
+        );
     }
 
     inline void clear_output(bool wait = false)
     {
-        xeus::get_interpreter().clear_output(wait);
+        publish_serialized(
+            [wait]()
+            {
+                xeus::get_interpreter().clear_output(wait);
+            }
+        );
     }
 }
 
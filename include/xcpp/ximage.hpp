@@ -0,0 +1,529 @@
+/************************************************************************************
+ * Copyright (c) 2025, xeus-cpp contributors                                        *
+ *                                                                                  *
+ * Distributed under the terms of the BSD 3-Clause License.                         *
+ *                                                                                  *
+ * The full license is in the file LICENSE, distributed with this software.         *
+ ************************************************************************************/
+
+#ifndef XCPP_IMAGE_HPP
+#define XCPP_IMAGE_HPP
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include <nlohmann/json.hpp>
+
+namespace nl = nlohmann;
+
+namespace xcpp
+{
+    /**************
+     * image_view *
+     **************/
+
+    // Non-owning view of 8-bit pixels in row-major order, with 1 (gray),
+    // 2 (gray and alpha), 3 (RGB) or 4 (RGBA) interleaved channels. Its mime
+    // bundle is a PNG image. Images larger than max_width x max_height are
+    // downscaled by an integer factor, averaging the pixels, before being
+    // encoded.
+    struct image_view
+    {
+        const std::uint8_t* data = nullptr;
+        std::size_t width = 0;
+        std::size_t height = 0;
+        std::size_t channels = 3;
+        // Bytes between the starts of two rows, width * channels when 0.
+        std::size_t stride = 0;
+        // 0 does not limit the size.
+        std::size_t max_width = 0;
+        std::size_t max_height = 0;
+
+        std::size_t row_size() const
+        {
+            return stride == 0 ? width * channels : stride;
+        }
+    };
+
+    namespace detail
+    {
+        /*******
+         * CRC *
+         *******/
+
+        inline const std::array<std::uint32_t, 256>& crc_table()
+        {
+            static const std::array<std::uint32_t, 256> table = []
+            {
+                std::array<std::uint32_t, 256> res = {};
+                for (std::uint32_t n = 0; n < 256; ++n)
+                {
+                    std::uint32_t c = n;
+                    for (int k = 0; k < 8; ++k)
+                    {
+                        c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+                    }
+                    res[n] = c;
+                }
+                return res;
+            }();
+            return table;
+        }
+
+        inline std::uint32_t crc32(const std::uint8_t* data, std::size_t size, std::uint32_t crc = 0)
+        {
+            const auto& table = crc_table();
+            crc = ~crc;
+            for (std::size_t i = 0; i < size; ++i)
+            {
+                crc = table[(crc ^ data[i]) & 0xFF] ^ (crc >> 8);
+            }
+            return ~crc;
+        }
+
+        inline std::uint32_t adler32(const std::uint8_t* data, std::size_t size)
+        {
+            // Largest number of bytes summed before the sums may overflow.
+            constexpr std::size_t nmax = 5552;
+            std::uint32_t a = 1;
+            std::uint32_t b = 0;
+            while (size != 0)
+            {
+                const std::size_t block = std::min(size, nmax);
+                for (std::size_t i = 0; i < block; ++i)
+                {
+                    a += data[i];
+                    b += a;
+                }
+                a %= 65521;
+                b %= 65521;
+                data += block;
+                size -= block;
+            }
+            return (b << 16) | a;
+        }
+
+        /***********
+         * deflate *
+         ***********/
+
+        // Writes bits least significant first into `out`, resized up front
+        // to `capacity` more bytes and shrunk to the bytes written by finish().
+        class bit_writer
+        {
+        public:
+
+            bit_writer(std::vector<std::uint8_t>& out, std::size_t capacity)
+                : m_out(out)
+                , m_start(out.size())
+                , m_size(0)
+                , m_bits(0)
+                , m_count(0)
+            {
+                m_out.resize(m_start + capacity + sizeof(m_bits));
+            }
+
+            // Writes the `count` low bits of `bits`, count <= 32.
+            void write(std::uint32_t bits, unsigned count)
+            {
+                m_bits |= static_cast<std::uint64_t>(bits) << m_count;
+                m_count += count;
+                if (m_count >= 32)
+                {
+                    const auto low = static_cast<std::uint32_t>(m_bits);
+                    std::uint8_t* out = m_out.data() + m_start + m_size;
+                    out[0] = static_cast<std::uint8_t>(low);
+                    out[1] = static_cast<std::uint8_t>(low >> 8);
+                    out[2] = static_cast<std::uint8_t>(low >> 16);
+                    out[3] = static_cast<std::uint8_t>(low >> 24);
+                    m_size += 4;
+                    m_bits >>= 32;
+                    m_count -= 32;
+                }
+            }
+
+            void finish()
+            {
+                while (m_count > 0)
+                {
+                    m_out[m_start + m_size++] = static_cast<std::uint8_t>(m_bits);
+                    m_bits >>= 8;
+                    m_count = m_count > 8 ? m_count - 8 : 0;
+                }
+                m_out.resize(m_start + m_size);
+            }
+
+        private:
+
+            std::vector<std::uint8_t>& m_out;
+            std::size_t m_start;
+            std::size_t m_size;
+            std::uint64_t m_bits;
+            unsigned m_count;
+        };
+
+        // Codes of the fixed Huffman tables of deflate, bit-reversed to be
+        // written least significant bit first.
+        struct fixed_huffman
+        {
+            struct code
+            {
+                std::uint16_t bits;
+                std::uint8_t length;
+            };
+
+            std::array<code, 288> literals;
+            // Indexed by match length, symbol and extra bits included.
+            std::array<code, 259> length_symbols;
+            std::array<std::uint8_t, 259> length_extra_bits;
+            std::array<std::uint16_t, 259> length_extra;
+            // Symbols of distances up to 256, then of the others divided by 128.
+            std::array<std::uint8_t, 512> distance_symbols;
+
+            static constexpr std::uint16_t length_base[29] = {3,  4,  5,  6,  7,  8,  9,   10,  11,  13,
+                                                              15, 17, 19, 23, 27, 31, 35,  43,  51,  59,
+                                                              67, 83, 99, 115, 131, 163, 195, 227, 258};
+            static constexpr std::uint8_t length_bits[29] = {0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2,
+                                                             2, 3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0};
+            static constexpr std::uint16_t distance_base[30] = {1,    2,    3,    4,     5,     7,    9,    13,
+                                                                17,   25,   33,   49,    65,    97,   129,  193,
+                                                                257,  385,  513,  769,   1025,  1537, 2049, 3073,
+                                                                4097, 6145, 8193, 12289, 16385, 24577};
+            static constexpr std::uint8_t distance_bits[30] = {0, 0, 0, 0, 1, 1, 2, 2,  3,  3,  4,  4,  5,  5,  6,
+                                                               6, 7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13};
+
+            static std::uint16_t reverse(std::uint16_t bits, unsigned length)
+            {
+                std::uint16_t res = 0;
+                for (unsigned i = 0; i < length; ++i)
+                {
+                    res = static_cast<std::uint16_t>((res << 1) | ((bits >> i) & 1));
+                }
+                return res;
+            }
+
+            fixed_huffman()
+                : literals()
+                , length_symbols()
+                , length_extra_bits()
+                , length_extra()
+                , distance_symbols()
+            {
+                for (unsigned s = 0; s < 288; ++s)
+                {
+                    unsigned bits = 0;
+                    unsigned length = 0;
+                    if (s < 144)
+                    {
+                        bits = 0x30 + s;
+                        length = 8;
+                    }
+                    else if (s < 256)
+                    {
+                        bits = 0x190 + s - 144;
+                        length = 9;
+                    }
+                    else if (s < 280)
+                    {
+                        bits = s - 256;
+                        length = 7;
+                    }
+                    else
+                    {
+                        bits = 0xC0 + s - 280;
+                        length = 8;
+                    }
+                    literals[s] = {reverse(static_cast<std::uint16_t>(bits), length), static_cast<std::uint8_t>(length)};
+                }
+                for (unsigned i = 0; i < 29; ++i)
+                {
+                    const unsigned last = i == 28 ? 258 : length_base[i + 1] - 1u;
+                    for (unsigned l = length_base[i]; l <= last && l <= 258; ++l)
+                    {
+                        length_symbols[l] = literals[257 + i];
+                        length_extra_bits[l] = length_bits[i];
+                        length_extra[l] = static_cast<std::uint16_t>(l - length_base[i]);
+                    }
+                }
+                for (unsigned i = 0; i < 30; ++i)
+                {
+                    const unsigned last = i == 29 ? 32768 : distance_base[i + 1] - 1u;
+                    for (unsigned d = distance_base[i]; d <= last; ++d)
+                    {
+                        distance_symbols[d <= 256 ? d - 1 : 256 + ((d - 1) >> 7)] = static_cast<std::uint8_t>(i);
+                    }
+                }
+            }
+
+            unsigned distance_symbol(std::size_t distance) const
+            {
+                return distance <= 256 ? distance_symbols[distance - 1] : distance_symbols[256 + ((distance - 1) >> 7)];
+            }
+
+            static const fixed_huffman& get()
+            {
+                static const fixed_huffman res;
+                return res;
+            }
+        };
+
+        inline std::uint32_t load32(const std::uint8_t* p)
+        {
+            std::uint32_t res;
+            std::memcpy(&res, p, sizeof(res));
+            return res;
+        }
+
+        // Single-pass deflate with the fixed Huffman tables. Matches are found
+        // through a hash table of the last position of each 4-byte sequence,
+        // without chains nor lazy matching: it trades some compression for a
+        // speed of the order of that of memcpy.
+        inline void deflate_fast(const std::uint8_t* data, std::size_t size, std::vector<std::uint8_t>& out)
+        {
+            constexpr unsigned hash_bits = 15;
+            constexpr std::size_t window = 32768;
+            constexpr std::size_t min_match = 4;
+            constexpr std::size_t max_match = 258;
+            const fixed_huffman& huffman = fixed_huffman::get();
+
+            std::vector<std::uint32_t> table(std::size_t(1) << hash_bits, 0);
+            // Literals take at most 9 bits, matches less than their length.
+            bit_writer writer(out, size / 8 * 9 + 16);
+            // Final block with the fixed tables.
+            writer.write(1, 1);
+            writer.write(1, 2);
+
+            auto literal = [&](std::uint8_t value)
+            {
+                const auto& code = huffman.literals[value];
+                writer.write(code.bits, code.length);
+            };
+
+            std::size_t i = 0;
+            while (i + min_match <= size)
+            {
+                const std::uint32_t sequence = load32(data + i);
+                const std::uint32_t hash = (sequence * 2654435761u) >> (32 - hash_bits);
+                // Positions are stored plus one, 0 means empty.
+                const std::size_t candidate = table[hash];
+                table[hash] = static_cast<std::uint32_t>(i + 1);
+                if (candidate != 0 && i + 1 - candidate <= window && load32(data + candidate - 1) == sequence)
+                {
+                    const std::uint8_t* match = data + candidate - 1;
+                    const std::size_t limit = std::min(max_match, size - i);
+                    std::size_t length = min_match;
+                    while (length < limit && match[length] == data[i + length])
+                    {
+                        ++length;
+                    }
+                    const std::size_t distance = i + 1 - candidate;
+
+                    const auto& code = huffman.length_symbols[length];
+                    writer.write(code.bits, code.length);
+                    writer.write(huffman.length_extra[length], huffman.length_extra_bits[length]);
+                    const unsigned symbol = huffman.distance_symbol(distance);
+                    writer.write(fixed_huffman::reverse(static_cast<std::uint16_t>(symbol), 5), 5);
+                    writer.write(
+                        static_cast<std::uint32_t>(distance - fixed_huffman::distance_base[symbol]),
+                        fixed_huffman::distance_bits[symbol]
+                    );
+                    i += length;
+                }
+                else
+                {
+                    literal(data[i]);
+                    ++i;
+                }
+            }
+            for (; i < size; ++i)
+            {
+                literal(data[i]);
+            }
+            const auto& end = huffman.literals[256];
+            writer.write(end.bits, end.length);
+            writer.finish();
+        }
+
+        /*******
+         * PNG *
+         *******/
+
+        inline void write_be32(std::vector<std::uint8_t>& out, std::uint32_t value)
+        {
+            out.push_back(static_cast<std::uint8_t>(value >> 24));
+            out.push_back(static_cast<std::uint8_t>(value >> 16));
+            out.push_back(static_cast<std::uint8_t>(value >> 8));
+            out.push_back(static_cast<std::uint8_t>(value));
+        }
+
+        inline void write_chunk(std::vector<std::uint8_t>& out, const char* type, const std::vector<std::uint8_t>& data)
+        {
+            write_be32(out, static_cast<std::uint32_t>(data.size()));
+            const std::size_t start = out.size();
+            out.insert(out.end(), type, type + 4);
+            out.insert(out.end(), data.begin(), data.end());
+            write_be32(out, crc32(out.data() + start, out.size() - start));
+        }
+
+        // Pixels of `image` reduced by an integer factor so that they fit in
+        // its maximum size, each one the average of the pixels it covers.
+        inline std::vector<std::uint8_t> downscale(const image_view& image, std::size_t factor)
+        {
+            const std::size_t width = (image.width + factor - 1) / factor;
+            const std::size_t height = (image.height + factor - 1) / factor;
+            const std::size_t channels = image.channels;
+            std::vector<std::uint8_t> res(width * height * channels);
+            std::vector<std::uint32_t> sums(width * channels);
+            std::vector<std::uint32_t> counts(width);
+            for (std::size_t y = 0; y < height; ++y)
+            {
+                std::fill(sums.begin(), sums.end(), 0);
+                std::fill(counts.begin(), counts.end(), 0);
+                const std::size_t last_row = std::min(image.height, (y + 1) * factor);
+                for (std::size_t row = y * factor; row < last_row; ++row)
+                {
+                    const std::uint8_t* pixels = image.data + row * image.row_size();
+                    for (std::size_t x = 0; x < image.width; ++x)
+                    {
+                        const std::size_t target = x / factor;
+                        for (std::size_t c = 0; c < channels; ++c)
+                        {
+                            sums[target * channels + c] += pixels[x * channels + c];
+                        }
+                        ++counts[target];
+                    }
+                }
+                for (std::size_t x = 0; x < width; ++x)
+                {
+                    for (std::size_t c = 0; c < channels; ++c)
+                    {
+                        res[(y * width + x) * channels + c] = static_cast<std::uint8_t>(
+                            (sums[x * channels + c] + counts[x] / 2) / counts[x]
+                        );
+                    }
+                }
+            }
+            return res;
+        }
+
+        inline std::size_t downscale_factor(const image_view& image)
+        {
+            std::size_t factor = 1;
+            if (image.max_width != 0)
+            {
+                factor = std::max(factor, (image.width + image.max_width - 1) / image.max_width);
+            }
+            if (image.max_height != 0)
+            {
+                factor = std::max(factor, (image.height + image.max_height - 1) / image.max_height);
+            }
+            return factor;
+        }
+    }
+
+    // PNG file of the pixels of `image`, downscaled to its maximum size.
+    inline std::vector<std::uint8_t> encode_png(const image_view& image)
+    {
+        static const std::uint8_t color_types[] = {0, 0, 4, 2, 6};
+        if (image.channels < 1 || image.channels > 4)
+        {
+            return {};
+        }
+
+        image_view source = image;
+        std::vector<std::uint8_t> scaled;
+        const std::size_t factor = detail::downscale_factor(image);
+        if (factor > 1)
+        {
+            scaled = detail::downscale(image, factor);
+            source.data = scaled.data();
+            source.width = (image.width + factor - 1) / factor;
+            source.height = (image.height + factor - 1) / factor;
+            source.stride = 0;
+        }
+
+        // Each row is preceded by its filter type. The "up" filter stores
+        // the difference with the previous row, cheap to compute and which
+        // turns smooth images into runs of small values.
+        const std::size_t row_size = source.width * source.channels;
+        std::vector<std::uint8_t> filtered((row_size + 1) * source.height);
+        for (std::size_t y = 0; y < source.height; ++y)
+        {
+            std::uint8_t* out = filtered.data() + y * (row_size + 1);
+            const std::uint8_t* row = source.data + y * source.row_size();
+            *out++ = 2;
+            if (y == 0)
+            {
+                std::memcpy(out, row, row_size);
+                continue;
+            }
+            const std::uint8_t* previous = row - source.row_size();
+            for (std::size_t x = 0; x < row_size; ++x)
+            {
+                out[x] = static_cast<std::uint8_t>(row[x] - previous[x]);
+            }
+        }
+
+        std::vector<std::uint8_t> idat = {0x78, 0x01};
+        detail::deflate_fast(filtered.data(), filtered.size(), idat);
+        detail::write_be32(idat, detail::adler32(filtered.data(), filtered.size()));
+
+        std::vector<std::uint8_t> header;
+        detail::write_be32(header, static_cast<std::uint32_t>(source.width));
+        detail::write_be32(header, static_cast<std::uint32_t>(source.height));
+        header.insert(header.end(), {8, color_types[source.channels], 0, 0, 0});
+
+        std::vector<std::uint8_t> res = {0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n'};
+        res.reserve(idat.size() + 64);
+        detail::write_chunk(res, "IHDR", header);
+        detail::write_chunk(res, "IDAT", idat);
+        detail::write_chunk(res, "IEND", {});
+        return res;
+    }
+
+    // Base64 encoding of `size` bytes, written into a string allocated once.
+    inline std::string base64_encode(const std::uint8_t* data, std::size_t size)
+    {
+        static const char alphabet[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+        std::string res((size + 2) / 3 * 4, '=');
+        char* out = res.data();
+        std::size_t i = 0;
+        for (; i + 3 <= size; i += 3)
+        {
+            const std::uint32_t n = (std::uint32_t(data[i]) << 16) | (std::uint32_t(data[i + 1]) << 8) | data[i + 2];
+            *out++ = alphabet[(n >> 18) & 63];
+            *out++ = alphabet[(n >> 12) & 63];
+            *out++ = alphabet[(n >> 6) & 63];
+            *out++ = alphabet[n & 63];
+        }
+        if (i < size)
+        {
+            const std::uint32_t n = (std::uint32_t(data[i]) << 16)
+                                    | (i + 1 < size ? std::uint32_t(data[i + 1]) << 8 : 0);
+            *out++ = alphabet[(n >> 18) & 63];
+            *out++ = alphabet[(n >> 12) & 63];
+            if (i + 1 < size)
+            {
+                *out++ = alphabet[(n >> 6) & 63];
+            }
+        }
+        return res;
+    }
+
+    inline nl::json mime_bundle_repr(const image_view& image)
+    {
+        const std::vector<std::uint8_t> png = encode_png(image);
+        auto bundle = nl::json::object();
+        bundle["image/png"] = base64_encode(png.data(), png.size());
+        bundle["text/plain"] = "<image " + std::to_string(image.width) + "x" + std::to_string(image.height) + "x"
+                               + std::to_string(image.channels) + ">";
+        return bundle;
+    }
+}
+
+#endif
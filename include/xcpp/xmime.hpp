@@ -10,14 +10,49 @@
 #ifndef XCPP_MIME_HPP
 #define XCPP_MIME_HPP
 
+#include <algorithm>
+#include <array>
+#include <charconv>
+#include <cstddef>
+#include <iterator>
+#include <limits>
+#include <locale>
 #include <sstream>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#if __cplusplus >= 202002L
+#include <span>
+#endif
 
 #include <nlohmann/json.hpp>
 
+#include "xcpp/ximage.hpp"
+
 namespace nl = nlohmann;
 
 namespace xcpp
 {
+    // Options of the representation of contiguous ranges of numbers, in the
+    // spirit of numpy.set_printoptions.
+    struct repr_options
+    {
+        // Ranges with more elements only show the first and last edge_items,
+        // at least one.
+        std::size_t threshold = 1000;
+        std::size_t edge_items = 3;
+        // Adds a text/html table to the text/plain representation.
+        bool html = true;
+    };
+
+    inline repr_options& get_repr_options()
+    {
+        static repr_options options;
+        return options;
+    }
+
     namespace detail
     {
         // Generic mime_bundle_repr() implementation
@@ -34,13 +69,200 @@ namespace xcpp
             return bundle;
         }
 
+        template <class T>
+        struct is_numeric_element
+            : std::bool_constant<
+                  std::is_arithmetic_v<T> && !std::is_same_v<T, char> && !std::is_same_v<T, signed char>
+                  && !std::is_same_v<T, unsigned char> && !std::is_same_v<T, wchar_t>
+                  && !std::is_same_v<T, char16_t> && !std::is_same_v<T, char32_t>
+#if defined(__cpp_char8_t)
+                  && !std::is_same_v<T, char8_t>
+#endif
+                  >
+        {
+        };
+
+        // Contiguous ranges of numbers: arrays, std::array, std::vector and
+        // std::span. Other types, even with data() and size(), keep their
+        // operator<<, which may know their shape. Ranges of characters are
+        // left to the stream path.
+        template <class T>
+        struct is_numeric_range : std::false_type
+        {
+        };
+
+        template <class T, std::size_t N>
+        struct is_numeric_range<T[N]> : is_numeric_element<std::remove_cv_t<T>>
+        {
+        };
+
+        template <class T, std::size_t N>
+        struct is_numeric_range<std::array<T, N>> : is_numeric_element<T>
+        {
+        };
+
+        template <class A>
+        struct is_numeric_range<std::vector<bool, A>> : std::false_type
+        {
+        };
+
+        template <class T, class A>
+        struct is_numeric_range<std::vector<T, A>> : is_numeric_element<T>
+        {
+        };
+
+#if __cplusplus >= 202002L
+        template <class T, std::size_t E>
+        struct is_numeric_range<std::span<T, E>> : is_numeric_element<std::remove_cv_t<T>>
+        {
+        };
+#endif
+
+        template <class T>
+        constexpr std::size_t max_chars()
+        {
+            if constexpr (std::is_same_v<T, bool>)
+            {
+                // "false"
+                return 5;
+            }
+            else if constexpr (std::is_floating_point_v<T>)
+            {
+                // Sign, digits, point and exponent of the shortest representation.
+                return std::numeric_limits<T>::max_digits10 + 10;
+            }
+            else
+            {
+                return std::numeric_limits<T>::digits10 + 3;
+            }
+        }
+
+        // Writes `value` at `first`, which must have room for max_chars<T>()
+        // characters, and returns the end of the written characters.
+        template <class T>
+        char* write_number(char* first, T value)
+        {
+            if constexpr (std::is_same_v<T, bool>)
+            {
+                const char* text = value ? "true" : "false";
+                const std::size_t size = value ? 4 : 5;
+                std::char_traits<char>::copy(first, text, size);
+                return first + size;
+            }
+#if !defined(__cpp_lib_to_chars)
+            else if constexpr (std::is_floating_point_v<T>)
+            {
+                // Standard libraries without std::to_chars for floating point
+                // values, the stream is only created for them.
+                std::ostringstream oss;
+                oss.imbue(std::locale::classic());
+                oss.precision(std::numeric_limits<T>::max_digits10);
+                oss << value;
+                const std::string text = oss.str();
+                std::char_traits<char>::copy(first, text.data(), text.size());
+                return first + text.size();
+            }
+#endif
+            else
+            {
+                return std::to_chars(first, first + max_chars<T>(), value).ptr;
+            }
+        }
+
+        // Text of the elements shown, numpy style: all of them up to the
+        // threshold, the first and last edge_items otherwise, separated by an
+        // ellipsis.
+        template <class T>
+        std::string format_numbers(const T* data, std::size_t size, const repr_options& options)
+        {
+            if (size == 0)
+            {
+                return "{}";
+            }
+            const std::size_t edge = std::max<std::size_t>(options.edge_items, 1);
+            const bool elided = size > options.threshold && size > 2 * edge;
+            const std::size_t shown = elided ? 2 * edge : size;
+            // Room for the braces and the ellipsis.
+            std::string res;
+            res.resize(shown * (max_chars<T>() + 2) + 16);
+            char* out = res.data();
+            *out++ = '{';
+            *out++ = ' ';
+            for (std::size_t i = 0; i < size; ++i)
+            {
+                if (elided && i == edge)
+                {
+                    std::char_traits<char>::copy(out, "..., ", 5);
+                    out += 5;
+                    i = size - edge;
+                }
+                out = write_number(out, data[i]);
+                if (i + 1 != size)
+                {
+                    std::char_traits<char>::copy(out, ", ", 2);
+                    out += 2;
+                }
+            }
+            *out++ = ' ';
+            *out++ = '}';
+            res.resize(static_cast<std::size_t>(out - res.data()));
+            return res;
+        }
+
+        template <class T>
+        std::string format_html(const T* data, std::size_t size, const repr_options& options)
+        {
+            const std::size_t edge = std::max<std::size_t>(options.edge_items, 1);
+            const bool elided = size > options.threshold && size > 2 * edge;
+            std::string res = "<table>\n<tr><th></th><th>value</th></tr>\n";
+            res.reserve(res.size() + (elided ? 2 * edge + 1 : size) * (2 * max_chars<T>() + 40));
+            char buffer[max_chars<T>() + max_chars<std::size_t>()];
+            for (std::size_t i = 0; i < size; ++i)
+            {
+                if (elided && i == edge)
+                {
+                    res += "<tr><th>&#8942;</th><td>&#8942;</td></tr>\n";
+                    i = size - edge;
+                }
+                res += "<tr><th>";
+                res.append(buffer, write_number(buffer, i));
+                res += "</th><td>";
+                res.append(buffer, write_number(buffer, data[i]));
+                res += "</td></tr>\n";
+            }
+            res += "</table>";
+            return res;
+        }
+
+        template <class T>
+        nl::json mime_bundle_repr_numeric(const T& value)
+        {
+            const auto* data = std::data(value);
+            const auto size = static_cast<std::size_t>(std::size(value));
+            const repr_options& options = get_repr_options();
+
+            auto bundle = nl::json::object();
+            bundle["text/plain"] = format_numbers(data, size, options);
+            if (options.html)
+            {
+                bundle["text/html"] = format_html(data, size, options);
+            }
+            return bundle;
+        }
     }
 
     // Default implementation of mime_bundle_repr
     template <class T>
     nl::json mime_bundle_repr(const T& value)
     {
-        return detail::mime_bundle_repr_via_sstream(value);
+        if constexpr (detail::is_numeric_range<T>::value)
+        {
+            return detail::mime_bundle_repr_numeric(value);
+        }
+        else
+        {
+            return detail::mime_bundle_repr_via_sstream(value);
+        }
     }
 }
 
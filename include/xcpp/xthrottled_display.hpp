@@ -0,0 +1,301 @@
+/************************************************************************************
+ * Copyright (c) 2025, xeus-cpp contributors                                        *
+ *                                                                                  *
+ * Distributed under the terms of the BSD 3-Clause License.                         *
+ *                                                                                  *
+ * The full license is in the file LICENSE, distributed with this software.         *
+ ************************************************************************************/
+
+#ifndef XCPP_THROTTLED_DISPLAY_HPP
+#define XCPP_THROTTLED_DISPLAY_HPP
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <utility>
+
+#include <nlohmann/json.hpp>
+
+#include "xcpp/xmime.hpp"
+
+#include "xeus/xguid.hpp"
+#include "xeus/xinterpreter.hpp"
+
+#include "xeus-cpp/xiopub.hpp"
+
+namespace nl = nlohmann;
+
+namespace xcpp
+{
+    /*********************
+     * throttled_display *
+     *********************/
+
+    // Display updated at most `max_rate` times per second, whatever the rate
+    // of the calls to update(). Only the latest value is kept: update()
+    // replaces it and returns, the value is rendered and published by a
+    // thread of the display. The value pending when the display is flushed
+    // or destroyed, or when the cell ends, is always published. update() may
+    // be called from any thread. The thread is stopped at the end of each
+    // cell, so that nothing is published after its reply, and started again
+    // by the next update.
+    template <class T>
+    class throttled_display
+    {
+    public:
+
+        // Called with the value to publish and whether it is the first one,
+        // which creates the display.
+        using publish_function = std::function<void(const T&, bool)>;
+
+        explicit throttled_display(double max_rate = 10., xeus::xguid id = xeus::new_xguid());
+        throttled_display(double max_rate, publish_function publish);
+        ~throttled_display();
+
+        throttled_display(const throttled_display&) = delete;
+        throttled_display& operator=(const throttled_display&) = delete;
+        throttled_display(throttled_display&&) = delete;
+        throttled_display& operator=(throttled_display&&) = delete;
+
+        void update(T value);
+        // Publishes the pending value, if any, without waiting for the rate.
+        void flush();
+
+        // Number of values published so far.
+        std::size_t published() const;
+
+    private:
+
+        using clock = std::chrono::steady_clock;
+
+        // Shared with the thread and the cell end callback rather than
+        // referenced through `this`, so that a display left in the frames
+        // of an interrupted cell, which are not unwound, is only leaked.
+        struct state
+        {
+            void start_publisher();
+            void stop_publisher();
+            void finish_cell();
+            void publish_loop();
+            void publish_pending();
+            void report_error(const char* what);
+
+            publish_function m_publish;
+            clock::duration m_interval = clock::duration::zero();
+            clock::time_point m_next;
+            std::optional<T> m_pending;
+            std::size_t m_published = 0;
+            bool m_stopping = false;
+            // Only the first failure to publish is reported, a failing
+            // renderer would otherwise report every update.
+            bool m_reported = false;
+            // Taken before m_mutex by the threads publishing, so that values
+            // are published in order.
+            std::mutex m_publish_mutex;
+            mutable std::mutex m_mutex;
+            std::condition_variable m_cv;
+            // Serializes the starts and stops of the thread.
+            std::mutex m_thread_mutex;
+            std::thread m_publisher;
+        };
+
+        std::shared_ptr<state> m_state;
+        std::size_t m_cell_end;
+    };
+
+    /************************************
+     * throttled_display implementation *
+     ************************************/
+
+    template <class T>
+    throttled_display<T>::throttled_display(double max_rate, xeus::xguid id)
+        : throttled_display(
+              max_rate,
+              [id = std::move(id)](const T& value, bool first)
+              {
+                  using ::xcpp::mime_bundle_repr;
+                  nl::json transient;
+                  transient["display_id"] = id;
+                  publish_serialized(
+                      [bundle = mime_bundle_repr(value), transient = std::move(transient), first]() mutable
+                      {
+                          if (first)
+                          {
+                              xeus::get_interpreter()
+                                  .display_data(std::move(bundle), nl::json::object(), std::move(transient));
+                          }
+                          else
+                          {
+                              xeus::get_interpreter()
+                                  .update_display_data(std::move(bundle), nl::json::object(), std::move(transient));
+                          }
+                      }
+                  );
+              }
+          )
+    {
+    }
+
+    template <class T>
+    throttled_display<T>::throttled_display(double max_rate, publish_function publish)
+        : m_state(std::make_shared<state>())
+        , m_cell_end(0)
+    {
+        m_state->m_publish = std::move(publish);
+        if (max_rate > 0.)
+        {
+            m_state->m_interval = std::chrono::duration_cast<clock::duration>(
+                std::chrono::duration<double>(1. / max_rate)
+            );
+        }
+        m_state->m_next = clock::now();
+        m_cell_end = add_cell_end_callback(
+            [shared = m_state]()
+            {
+                shared->finish_cell();
+            }
+        );
+    }
+
+    template <class T>
+    throttled_display<T>::~throttled_display()
+    {
+        // Waits for the end of the cell if it is finishing this display.
+        remove_cell_end_callback(m_cell_end);
+        m_state->stop_publisher();
+    }
+
+    template <class T>
+    void throttled_display<T>::update(T value)
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_state->m_mutex);
+            m_state->m_pending = std::move(value);
+        }
+        m_state->start_publisher();
+        m_state->m_cv.notify_one();
+    }
+
+    template <class T>
+    void throttled_display<T>::flush()
+    {
+        std::lock_guard<std::mutex> publish_lock(m_state->m_publish_mutex);
+        m_state->publish_pending();
+    }
+
+    template <class T>
+    std::size_t throttled_display<T>::published() const
+    {
+        std::lock_guard<std::mutex> lock(m_state->m_mutex);
+        return m_state->m_published;
+    }
+
+    template <class T>
+    void throttled_display<T>::state::start_publisher()
+    {
+        std::lock_guard<std::mutex> thread_lock(m_thread_mutex);
+        if (!m_publisher.joinable())
+        {
+            m_publisher = std::thread(&state::publish_loop, this);
+        }
+    }
+
+    template <class T>
+    void throttled_display<T>::state::stop_publisher()
+    {
+        std::lock_guard<std::mutex> thread_lock(m_thread_mutex);
+        if (!m_publisher.joinable())
+        {
+            return;
+        }
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_stopping = true;
+        }
+        m_cv.notify_one();
+        m_publisher.join();
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stopping = false;
+    }
+
+    template <class T>
+    void throttled_display<T>::state::finish_cell()
+    {
+        {
+            std::lock_guard<std::mutex> publish_lock(m_publish_mutex);
+            publish_pending();
+        }
+        stop_publisher();
+    }
+
+    template <class T>
+    void throttled_display<T>::state::publish_loop()
+    {
+        while (true)
+        {
+            {
+                std::unique_lock<std::mutex> lock(m_mutex);
+                m_cv.wait(lock, [this] { return m_pending.has_value() || m_stopping; });
+                // Updates made while waiting for the next slot replace the
+                // pending value, only the last one is published.
+                m_cv.wait_until(lock, m_next, [this] { return m_stopping; });
+                if (m_stopping && !m_pending)
+                {
+                    return;
+                }
+            }
+            std::lock_guard<std::mutex> publish_lock(m_publish_mutex);
+            publish_pending();
+        }
+    }
+
+    template <class T>
+    void throttled_display<T>::state::publish_pending()
+    {
+        std::optional<T> value;
+        bool first = false;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (!m_pending)
+            {
+                return;
+            }
+            value.swap(m_pending);
+            first = m_published == 0;
+            ++m_published;
+            m_next = clock::now() + m_interval;
+        }
+        try
+        {
+            m_publish(*value, first);
+        }
+        catch (const std::exception& e)
+        {
+            report_error(e.what());
+        }
+        catch (...)
+        {
+            report_error("unknown exception");
+        }
+    }
+
+    template <class T>
+    void throttled_display<T>::state::report_error(const char* what)
+    {
+        // Called with m_publish_mutex held.
+        if (!m_reported)
+        {
+            m_reported = true;
+            std::cerr << "throttled_display: failed to publish a value: " << what << std::endl;
+        }
+    }
+}
+
+#endif
@@ -10,11 +10,23 @@
 #ifndef XEUS_CPP_BUFFER_HPP
 #define XEUS_CPP_BUFFER_HPP
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
 #include <functional>
+#include <iterator>
 #include <memory>
 #include <mutex>
+#include <new>
 #include <streambuf>
 #include <string>
+#include <thread>
+#include <utility>
+#include <vector>
 
 namespace xcpp
 {
@@ -22,6 +34,15 @@ namespace xcpp
      * output streambuf *
      ********************/
 
+    // Writes are staged in a buffer owned by the writing thread, and moved
+    // by whole lines to a lock-free queue shared by the threads. Threads do
+    // not contend on writes, and the lines they print are not interleaved.
+    // The staged output of a thread is queued when it flushes the stream or
+    // when it exceeds a few kilobytes, the queue is published by the thread
+    // that flushes, or as soon as it exceeds a megabyte. A thread flushing
+    // while no other one publishes skips the queue. flush_pending also
+    // publishes what the other threads staged, and must be called once they
+    // stopped writing.
     class xoutput_buffer : public std::streambuf
     {
     public:
@@ -29,48 +50,406 @@ namespace xcpp
         using base_type = std::streambuf;
         using callback_type = std::function<void(const std::string&)>;
         using traits_type = base_type::traits_type;
+        using clock_type = std::chrono::steady_clock;
 
         xoutput_buffer(callback_type callback)
             : m_callback(std::move(callback))
+            , m_id(next_id())
+            , m_head(nullptr)
+            , m_pending_size(0)
+            , m_consuming(false)
+            , m_interval(0)
+            , m_max_size(0)
+            , m_flush_requested(false)
+            , m_stop(false)
         {
         }
 
+        ~xoutput_buffer() override
+        {
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                m_stop = true;
+            }
+            m_cv.notify_all();
+            if (m_flusher.joinable())
+            {
+                m_flusher.join();
+            }
+            delete_nodes(m_head.exchange(nullptr));
+        }
+
+        // Batches the flushes of the stream: the output is published once
+        // `interval` has elapsed since the first flush requested, or as soon
+        // as `max_size` bytes are pending when `max_size` is not zero. A zero
+        // interval publishes on every flush.
+        void set_coalescing(std::chrono::milliseconds interval, std::size_t max_size)
+        {
+            m_interval = interval.count();
+            m_max_size = max_size;
+            if (interval.count() == 0)
+            {
+                flush_pending();
+            }
+        }
+
+        // Publishes the output held back by the coalescing and the output
+        // staged by all the threads.
+        void flush_pending()
+        {
+            {
+                std::lock_guard<std::mutex> lock(m_registry_mutex);
+                for (auto it = m_stagings.begin(); it != m_stagings.end();)
+                {
+                    queue_staged(**it, false);
+                    // Only referenced here once its thread exited.
+                    it = it->use_count() == 1 ? m_stagings.erase(it) : std::next(it);
+                }
+            }
+            acquire_consumer();
+            m_flush_requested = false;
+            drain();
+            release_consumer();
+        }
+
     protected:
 
         traits_type::int_type overflow(traits_type::int_type c) override
         {
-            std::lock_guard<std::mutex> lock(m_mutex);
             // Called for each output character.
             if (!traits_type::eq_int_type(c, traits_type::eof()))
             {
-                m_output.push_back(traits_type::to_char_type(c));
+                const char ch = traits_type::to_char_type(c);
+                write(&ch, 1);
             }
             return c;
         }
 
         std::streamsize xsputn(const char* s, std::streamsize count) override
         {
-            std::lock_guard<std::mutex> lock(m_mutex);
             // Called for a string of characters.
-            m_output.append(s, static_cast<std::size_t>(count));
+            write(s, static_cast<std::size_t>(count));
             return count;
         }
 
         traits_type::int_type sync() override
         {
-            std::lock_guard<std::mutex> lock(m_mutex);
             // Called in case of flush.
-            if (!m_output.empty())
+            staging& area = local_staging();
+            if (m_interval == 0 && !m_consuming.exchange(true))
+            {
+                // Publishes the staged output directly, without going
+                // through the queue, after what other threads queued.
+                m_flush_requested = false;
+                drain();
+                publish_staged(area);
+                release_consumer();
+                return 0;
+            }
+            queue_staged(area, false);
+            if (m_interval == 0 || (m_max_size != 0 && m_pending_size >= m_max_size))
             {
-                m_callback(m_output);
-                m_output.clear();
+                publish_queue();
+            }
+            else if (m_head.load() != nullptr && !m_flush_requested.load() && !m_flush_requested.exchange(true))
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                m_deadline = clock_type::now() + std::chrono::milliseconds(m_interval.load());
+                // Started on first use, so that kernels forked from a warm
+                // interpreter run their own.
+                if (!m_flusher.joinable())
+                {
+                    m_flusher = std::thread(&xoutput_buffer::flush_loop, this);
+                }
+                m_cv.notify_one();
             }
             return 0;
         }
 
+    private:
+
+        // Lock of a staging area, only contended when flush_pending collects
+        // the output of the other threads. Cheaper than a mutex to take on
+        // every write.
+        class spin_lock
+        {
+        public:
+
+            void lock()
+            {
+                while (m_flag.test_and_set(std::memory_order_acquire))
+                {
+                    std::this_thread::yield();
+                }
+            }
+
+            void unlock()
+            {
+                m_flag.clear(std::memory_order_release);
+            }
+
+        private:
+
+            std::atomic_flag m_flag = ATOMIC_FLAG_INIT;
+        };
+
+        // Staged output of one thread.
+        struct staging
+        {
+            spin_lock mutex;
+            std::string data;
+            // Output being published by the thread, kept to reuse its
+            // capacity.
+            std::string published;
+        };
+
+        // Queued output, stored after the node in the same allocation.
+        struct node
+        {
+            node* next;
+            std::size_t size;
+
+            const char* data() const
+            {
+                return reinterpret_cast<const char*>(this + 1);
+            }
+
+            static node* create(const char* data, std::size_t size)
+            {
+                auto* item = new (::operator new(sizeof(node) + size)) node{nullptr, size};
+                std::memcpy(item + 1, data, size);
+                return item;
+            }
+        };
+
+        // Size above which the complete lines staged by a thread are queued,
+        // and above which a line is split.
+        static constexpr std::size_t staging_size = 4096;
+        static constexpr std::size_t max_line_size = 65536;
+        // Size of the queue above which it is published without waiting for
+        // a flush, so that the memory used stays bounded.
+        static constexpr std::size_t max_pending_size = 1 << 20;
+
+        static std::uint64_t next_id()
+        {
+            static std::atomic<std::uint64_t> id(0);
+            return ++id;
+        }
+
+        staging& local_staging()
+        {
+            // Buffers are identified by a unique id rather than by their
+            // address, which may be reused.
+            static thread_local std::vector<std::pair<std::uint64_t, std::shared_ptr<staging>>> stagings;
+            static thread_local std::pair<std::uint64_t, staging*> last(0, nullptr);
+            if (last.first == m_id)
+            {
+                return *last.second;
+            }
+            for (auto& [id, area] : stagings)
+            {
+                if (id == m_id)
+                {
+                    last = {id, area.get()};
+                    return *area;
+                }
+            }
+            // Entries of destroyed buffers are only referenced here.
+            stagings.erase(
+                std::remove_if(
+                    stagings.begin(),
+                    stagings.end(),
+                    [](const auto& entry)
+                    {
+                        return entry.second.use_count() == 1;
+                    }
+                ),
+                stagings.end()
+            );
+            auto area = std::make_shared<staging>();
+            {
+                std::lock_guard<std::mutex> lock(m_registry_mutex);
+                m_stagings.push_back(area);
+            }
+            stagings.emplace_back(m_id, area);
+            last = {m_id, area.get()};
+            return *area;
+        }
+
+        void write(const char* s, std::size_t count)
+        {
+            staging& area = local_staging();
+            std::size_t staged = 0;
+            {
+                std::lock_guard<spin_lock> lock(area.mutex);
+                area.data.append(s, count);
+                staged = area.data.size();
+            }
+            if (staged >= staging_size)
+            {
+                queue_staged(area, staged < max_line_size);
+                if (m_pending_size >= max_pending_size
+                    || (m_interval != 0 && m_max_size != 0 && m_pending_size >= m_max_size))
+                {
+                    publish_queue();
+                }
+            }
+        }
+
+        // Moves the staged output to the queue, up to the last end of line
+        // if `lines_only` is set.
+        void queue_staged(staging& area, bool lines_only)
+        {
+            node* item = nullptr;
+            {
+                std::lock_guard<spin_lock> lock(area.mutex);
+                std::size_t length = area.data.size();
+                if (lines_only)
+                {
+                    const std::size_t end_of_line = area.data.rfind('\n');
+                    length = end_of_line == std::string::npos ? 0 : end_of_line + 1;
+                }
+                if (length == 0)
+                {
+                    return;
+                }
+                // Copied rather than moved, so that the staging area keeps
+                // its capacity.
+                item = node::create(area.data.data(), length);
+                area.data.erase(0, length);
+            }
+            m_pending_size += item->size;
+            item->next = m_head.load();
+            while (!m_head.compare_exchange_weak(item->next, item))
+            {
+            }
+        }
+
+        // Publishes the queue unless another thread is publishing it, in
+        // which case that thread publishes what was queued meanwhile.
+        void publish_queue()
+        {
+            while (m_head.load() != nullptr)
+            {
+                if (m_consuming.exchange(true))
+                {
+                    return;
+                }
+                m_flush_requested = false;
+                drain();
+                m_consuming = false;
+            }
+        }
+
+        void acquire_consumer()
+        {
+            while (m_consuming.exchange(true))
+            {
+                std::this_thread::yield();
+            }
+        }
+
+        void release_consumer()
+        {
+            m_consuming = false;
+            publish_queue();
+        }
+
+        // Must be called by the only consumer, from the thread owning `area`.
+        void publish_staged(staging& area)
+        {
+            area.published.clear();
+            {
+                std::lock_guard<spin_lock> lock(area.mutex);
+                area.published.swap(area.data);
+            }
+            if (!area.published.empty())
+            {
+                m_callback(area.published);
+            }
+        }
+
+        // Must be called by the only consumer.
+        void drain()
+        {
+            node* items = m_head.exchange(nullptr);
+            // The queue is a stack, reverse it to publish in order.
+            node* ordered = nullptr;
+            while (items != nullptr)
+            {
+                node* next = items->next;
+                items->next = ordered;
+                ordered = items;
+                items = next;
+            }
+            std::size_t size = 0;
+            for (node* item = ordered; item != nullptr; item = item->next)
+            {
+                size += item->size;
+            }
+            std::string output;
+            output.reserve(size);
+            for (node* item = ordered; item != nullptr; item = item->next)
+            {
+                output.append(item->data(), item->size);
+            }
+            delete_nodes(ordered);
+            m_pending_size -= output.size();
+            if (!output.empty())
+            {
+                m_callback(output);
+            }
+        }
+
+        static void delete_nodes(node* items)
+        {
+            while (items != nullptr)
+            {
+                node* next = items->next;
+                ::operator delete(items);
+                items = next;
+            }
+        }
+
+        void flush_loop()
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            while (!m_stop)
+            {
+                if (!m_flush_requested)
+                {
+                    m_cv.wait(lock);
+                }
+                else if (m_cv.wait_until(lock, m_deadline) == std::cv_status::timeout && m_flush_requested)
+                {
+                    lock.unlock();
+                    acquire_consumer();
+                    m_flush_requested = false;
+                    drain();
+                    release_consumer();
+                    lock.lock();
+                }
+            }
+        }
+
         callback_type m_callback;
-        std::string m_output;
+        const std::uint64_t m_id;
+
+        std::mutex m_registry_mutex;
+        std::vector<std::shared_ptr<staging>> m_stagings;
+
+        std::atomic<node*> m_head;
+        std::atomic<std::size_t> m_pending_size;
+        std::atomic<bool> m_consuming;
+
+        std::atomic<long long> m_interval;
+        std::atomic<std::size_t> m_max_size;
+        std::atomic<bool> m_flush_requested;
         std::mutex m_mutex;
+        clock_type::time_point m_deadline;
+        bool m_stop;
+        std::condition_variable m_cv;
+        std::thread m_flusher;
     };
 
     /*******************
@@ -11,6 +11,7 @@
 #ifndef XEUS_CPP_INTERPRETER_HPP
 #define XEUS_CPP_INTERPRETER_HPP
 
+#include <chrono>
 #include <memory>
 #include <streambuf>
 #include <string>
@@ -30,6 +31,14 @@ namespace nl = nlohmann;
 
 namespace xcpp
 {
+    class xcell_cache;
+    class xcompletion_cache;
+    class xcompletion_task;
+    class xoptimizer;
+    class xoutput_limiter;
+    class xstats;
+    class xsymbol_index;
+
     class XEUS_CPP_API interpreter : public xeus::xinterpreter
     {
     public:
@@ -70,8 +79,13 @@ namespace xcpp
             const std::vector<std::string>& trace_back
         );
 
+        bool wait_completion(std::chrono::steady_clock::time_point deadline);
+        void finish_completion();
+
         void redirect_output();
         void restore_output();
+        void start_output();
+        void flush_output();
 
         void init_includes();
         void init_preamble();
@@ -81,12 +95,40 @@ namespace xcpp
 
         std::string m_language;
 
+        std::vector<std::string> m_interpreter_args;
+        std::string m_flags_digest;
+        std::string m_cell_key;
+        // Cleared once a cell that depends on external files succeeded: the
+        // key chain no longer determines the state seen by the next cells.
+        bool m_replayable;
+        // Top-level declarations of the cells compiled so far, in order.
+        std::vector<std::string> m_declarations;
+        std::unique_ptr<xoptimizer> m_optimizer;
+        std::unique_ptr<xcell_cache> m_cell_cache;
+        std::unique_ptr<xcompletion_cache> m_completion_cache;
+        // Completion still running after its budget, 0 waits for completions.
+        std::unique_ptr<xcompletion_task> m_completion_task;
+        std::chrono::milliseconds m_completion_timeout;
+        // Whether a completion already finished, the budget only applies
+        // from then on.
+        bool m_completion_warm;
+        std::unique_ptr<xstats> m_stats;
+        // Names declared by the cells, for completion, inspection and %who.
+        std::unique_ptr<xsymbol_index> m_symbol_index;
+
         xmagics_manager xmagics;
         xpreamble_manager preamble_manager;
 
         std::streambuf* p_cout_strbuf;
         std::streambuf* p_cerr_strbuf;
 
+        // The output of the cells is published from the thread reading it,
+        // the limiters are only used under publish_serialized. Declared
+        // before the buffers, whose flushers publish until they are
+        // destroyed.
+        std::unique_ptr<xoutput_limiter> m_stdout_limiter;
+        std::unique_ptr<xoutput_limiter> m_stderr_limiter;
+
         xoutput_buffer m_cout_buffer;
         xoutput_buffer m_cerr_buffer;
     };
@@ -0,0 +1,51 @@
+/************************************************************************************
+ * Copyright (c) 2025, xeus-cpp contributors                                        *
+ *                                                                                  *
+ * Distributed under the terms of the BSD 3-Clause License.                         *
+ *                                                                                  *
+ * The full license is in the file LICENSE, distributed with this software.         *
+ ************************************************************************************/
+
+#ifndef XEUS_CPP_IOPUB_HPP
+#define XEUS_CPP_IOPUB_HPP
+
+#include <cstddef>
+#include <functional>
+
+#include "xeus_cpp_config.hpp"
+
+namespace xcpp
+{
+    // Runs `publish` under the lock taken by every publisher of the kernel,
+    // with interruptions deferred. xeus publishes on iopub from the calling
+    // thread, through sockets that are not thread-safe, so the shell thread
+    // and the threads forwarding output must take turns. Messages should be
+    // rendered before the call, which only needs to cover their sending.
+    // Called from another thread than the shell thread outside of a cell,
+    // `publish` is held until the next cell starts.
+    XEUS_CPP_API
+    void publish_serialized(std::function<void()> publish);
+
+    // Delimit the output of a cell, called from the shell thread. Between
+    // cells, xeus publishes its own messages without the lock, and with the
+    // parent header of the request being answered: the other threads wait
+    // for the next cell instead. `start` runs under the lock when the cell
+    // starts, before the messages held in between are published.
+    XEUS_CPP_API
+    void begin_cell_output(const std::function<void()>& start);
+
+    XEUS_CPP_API
+    void end_cell_output();
+
+    // Registers `finish`, called on the shell thread when each cell ends,
+    // by objects publishing from their own thread, which must have stopped
+    // when it returns. Returns the id to pass to remove_cell_end_callback,
+    // which waits for the callbacks running.
+    XEUS_CPP_API
+    std::size_t add_cell_end_callback(std::function<void()> finish);
+
+    XEUS_CPP_API
+    void remove_cell_end_callback(std::size_t id);
+}
+
+#endif
@@ -9,6 +9,7 @@
 #include <memory>
 #include <string>
 #include <utility>
+#include <vector>
 
 #include <signal.h>
 
@@ -30,6 +31,46 @@
 #include "xeus-cpp/xinterpreter.hpp"
 #include "xeus-cpp/xutils.hpp"
 
+#include "xinterrupt.hpp"
+
+#ifndef _WIN32
+#include <CppInterOp/CppInterOp.h>
+
+#include "xfork_server.hpp"
+#endif
+
+namespace
+{
+    void start_kernel(const std::string& file_name, std::unique_ptr<xcpp::interpreter> interpreter)
+    {
+        xcpp::init_interrupt_handling();
+        std::unique_ptr<xeus::xcontext> context = xeus::make_zmq_context();
+        xeus::xconfiguration config = xeus::load_configuration(file_name);
+
+        std::clog << "Instantiating kernel" << std::endl;
+        xeus::xkernel kernel(
+            config,
+            xeus::get_user_name(),
+            std::move(context),
+            std::move(interpreter),
+            xeus::make_xserver_default,
+            xeus::make_in_memory_history_manager(),
+            xeus::make_console_logger(
+                xeus::xlogger::msg_type,
+                xeus::make_file_logger(xeus::xlogger::content, "xeus.log")
+            )
+        );
+
+        std::clog << "Starting xcpp kernel...\n\n"
+                     "If you want to connect to this kernel from an other client, you can use"
+                     " the "
+                         + file_name + " file."
+                  << std::endl;
+
+        kernel.start();
+    }
+}
+
 int main(int argc, char* argv[])
 {
     if (xeus::should_print_version(argc, argv))
@@ -53,43 +94,58 @@ int main(int argc, char* argv[])
     std::clog << "registering handler for SIGSEGV" << std::endl;
     signal(SIGSEGV, xcpp::handler);
 
-    // Registering SIGINT and SIGKILL handlers
+    // Registering SIGKILL handler, SIGINT interrupts the running cell
     signal(SIGKILL, xcpp::stop_handler);
 #endif
-    signal(SIGINT, xcpp::stop_handler);
+
+#ifndef _WIN32
+    // Fork server mode: `xcpp --fork-server <socket> [--preload <header>]... [clang args]`
+    // keeps a warm interpreter and `xcpp --fork-client <socket> -f <connection file>`
+    // starts a kernel forked from it.
+    std::vector<std::string> fork_client = xcpp::extract_option(argc, argv, "--fork-client");
+    std::vector<std::string> fork_server = xcpp::extract_option(argc, argv, "--fork-server");
+    std::vector<std::string> preload = xcpp::extract_option(argc, argv, "--preload");
+#endif
 
     std::string file_name = xeus::extract_filename(argc, argv);
-    auto interpreter = std::make_unique<xcpp::interpreter>(argc, argv);
-    std::unique_ptr<xeus::xcontext> context = xeus::make_zmq_context();
 
-    if (!file_name.empty())
+#ifndef _WIN32
+    if (!fork_client.empty())
     {
-        xeus::xconfiguration config = xeus::load_configuration(file_name);
+        if (file_name.empty())
+        {
+            std::cerr << "--fork-client requires a connection file" << std::endl;
+            return 1;
+        }
+        return xcpp::run_fork_client(fork_client.back(), file_name);
+    }
+#endif
 
-        std::clog << "Instantiating kernel" << std::endl;
-        xeus::xkernel kernel(
-            config,
-            xeus::get_user_name(),
-            std::move(context),
-            std::move(interpreter),
-            xeus::make_xserver_default,
-            xeus::make_in_memory_history_manager(),
-            xeus::make_console_logger(
-                xeus::xlogger::msg_type,
-                xeus::make_file_logger(xeus::xlogger::content, "xeus.log")
-            )
-        );
+    auto interpreter = std::make_unique<xcpp::interpreter>(argc, argv);
 
-        std::clog << "Starting xcpp kernel...\n\n"
-                     "If you want to connect to this kernel from an other client, you can use"
-                     " the "
-                         + file_name + " file."
-                  << std::endl;
+#ifndef _WIN32
+    if (!fork_server.empty())
+    {
+        for (const std::string& header : preload)
+        {
+            std::string include = "#include <" + header + ">";
+            if (Cpp::Process(include.c_str()) != 0)
+            {
+                std::cerr << "Could not preload " << header << std::endl;
+            }
+        }
+        return xcpp::run_fork_server(fork_server.back(), std::move(interpreter), start_kernel);
+    }
+#endif
 
-        kernel.start();
+    if (!file_name.empty())
+    {
+        start_kernel(file_name, std::move(interpreter));
     }
     else
     {
+        xcpp::init_interrupt_handling();
+        std::unique_ptr<xeus::xcontext> context = xeus::make_zmq_context();
         xeus::xkernel kernel(
             xeus::get_user_name(),
             std::move(context),
@@ -0,0 +1,38 @@
+/************************************************************************************
+ * Copyright (c) 2025, xeus-cpp contributors                                        *
+ *                                                                                  *
+ * Distributed under the terms of the BSD 3-Clause License.                         *
+ *                                                                                  *
+ * The full license is in the file LICENSE, distributed with this software.         *
+ ************************************************************************************/
+
+#include <iostream>
+#include <string>
+
+#include "xtagfile_index.hpp"
+
+// Compiles the tagfiles listed in a tags.d directory into the index mapped
+// by the kernels:
+//
+//     xcpp-tagfile-index TAGCONF_DIR TAGFILE_DIR [OUTPUT]
+//
+// OUTPUT defaults to the compiled index of TAGFILE_DIR.
+int main(int argc, char* argv[])
+{
+    if (argc < 3 || argc > 4)
+    {
+        std::cerr << "usage: " << argv[0] << " TAGCONF_DIR TAGFILE_DIR [OUTPUT]" << std::endl;
+        return 2;
+    }
+    const std::string tagfile_dir = argv[2];
+    const std::string output = argc == 4 ? argv[3] : tagfile_dir + "/" + xcpp::compiled_tagfile_index;
+
+    xcpp::xtagfile_index index = xcpp::xtagfile_index::load(argv[1], tagfile_dir);
+    if (!index.save(output))
+    {
+        std::cerr << "Could not write " << output << std::endl;
+        return 1;
+    }
+    std::cout << "Indexed " << index.size() << " entries in " << output << std::endl;
+    return 0;
+}
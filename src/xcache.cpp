@@ -0,0 +1,295 @@
+/************************************************************************************
+ * Copyright (c) 2025, xeus-cpp contributors                                        *
+ *                                                                                  *
+ * Distributed under the terms of the BSD 3-Clause License.                         *
+ *                                                                                  *
+ * The full license is in the file LICENSE, distributed with this software.         *
+ ************************************************************************************/
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <nlohmann/json.hpp>
+
+#include "xcache.hpp"
+
+namespace fs = std::filesystem;
+namespace nl = nlohmann;
+
+namespace xcpp
+{
+    namespace
+    {
+        constexpr const char* cache_extension = ".xcell";
+
+        std::string to_hex(std::uint64_t value)
+        {
+            static const char* digits = "0123456789abcdef";
+            std::string res(16, '0');
+            for (std::size_t i = 0; i < 16; ++i)
+            {
+                res[15 - i] = digits[value & 0xf];
+                value >>= 4;
+            }
+            return res;
+        }
+    }
+
+    xcell_cache::xcell_cache(const std::string& directory, std::uintmax_t max_size)
+        : m_directory(directory)
+        , m_max_size(max_size)
+        , m_size(0)
+        , m_hits(0)
+        , m_misses(0)
+    {
+        if (!enabled())
+        {
+            return;
+        }
+
+        std::error_code ec;
+        fs::create_directories(m_directory, ec);
+        if (ec)
+        {
+            m_max_size = 0;
+            return;
+        }
+        load_index();
+    }
+
+    std::string xcell_cache::digest(const std::string& data)
+    {
+        // Two independent 64-bit FNV-1a streams. Keys are only used to locate
+        // entries, the stored cell text is compared on lookup.
+        std::uint64_t h1 = 0xcbf29ce484222325ULL;
+        std::uint64_t h2 = 0x84222325cbf29ce4ULL;
+        for (unsigned char c : data)
+        {
+            h1 = (h1 ^ c) * 0x100000001b3ULL;
+            h2 = (h2 ^ c) * 0x100000001b3ULL;
+            h2 ^= h2 >> 29;
+        }
+        return to_hex(h1) + to_hex(h2);
+    }
+
+    std::string
+    xcell_cache::make_key(const std::string& parent_key, const std::string& flags_digest, const std::string& code)
+    {
+        std::string data;
+        data.reserve(parent_key.size() + flags_digest.size() + code.size() + 2);
+        data.append(parent_key).append(1, '\0').append(flags_digest).append(1, '\0').append(code);
+        return digest(data);
+    }
+
+    bool xcell_cache::enabled() const
+    {
+        return m_max_size != 0 && !m_directory.empty();
+    }
+
+    bool xcell_cache::lookup(const std::string& key, const std::string& code, std::string& payload)
+    {
+        if (!enabled())
+        {
+            return false;
+        }
+
+        auto it = m_entries.find(key);
+        if (it == m_entries.end())
+        {
+            ++m_misses;
+            return false;
+        }
+
+        nl::json content;
+        std::ifstream in(entry_path(key));
+        if (in)
+        {
+            content = nl::json::parse(in, nullptr, false);
+        }
+        if (!content.is_object() || content.value("code", std::string()) != code)
+        {
+            // Either the entry was evicted by another kernel sharing the
+            // directory, or it is a hash collision.
+            remove(key);
+            ++m_misses;
+            return false;
+        }
+
+        payload = content.value("payload", std::string());
+        touch(key);
+        ++m_hits;
+        return true;
+    }
+
+    void xcell_cache::store(const std::string& key, const std::string& code, const std::string& payload)
+    {
+        if (!enabled())
+        {
+            return;
+        }
+
+        nl::json content = {{"key", key}, {"code", code}, {"payload", payload}};
+        std::string data = content.dump();
+
+        // Write to a temporary file first so that kernels sharing the cache
+        // directory never observe a partially written entry.
+        fs::path path = entry_path(key);
+        fs::path tmp_path = path;
+        tmp_path += ".tmp";
+        {
+            std::ofstream out(tmp_path, std::ios::binary | std::ios::trunc);
+            if (!out)
+            {
+                return;
+            }
+            out.write(data.data(), static_cast<std::streamsize>(data.size()));
+            if (!out)
+            {
+                return;
+            }
+        }
+        std::error_code ec;
+        fs::rename(tmp_path, path, ec);
+        if (ec)
+        {
+            fs::remove(tmp_path, ec);
+            return;
+        }
+
+        auto it = m_entries.find(key);
+        if (it != m_entries.end())
+        {
+            m_size -= it->second.size;
+            m_lru.erase(it->second.lru_it);
+            m_entries.erase(it);
+        }
+        m_lru.push_front(key);
+        m_entries[key] = entry{data.size(), m_lru.begin()};
+        m_size += data.size();
+        evict();
+    }
+
+    void xcell_cache::clear()
+    {
+        while (!m_lru.empty())
+        {
+            remove(m_lru.back());
+        }
+        m_hits = 0;
+        m_misses = 0;
+    }
+
+    std::size_t xcell_cache::hits() const
+    {
+        return m_hits;
+    }
+
+    std::size_t xcell_cache::misses() const
+    {
+        return m_misses;
+    }
+
+    std::size_t xcell_cache::entries() const
+    {
+        return m_entries.size();
+    }
+
+    std::uintmax_t xcell_cache::size() const
+    {
+        return m_size;
+    }
+
+    std::uintmax_t xcell_cache::max_size() const
+    {
+        return m_max_size;
+    }
+
+    fs::path xcell_cache::entry_path(const std::string& key) const
+    {
+        return m_directory / (key + cache_extension);
+    }
+
+    void xcell_cache::load_index()
+    {
+        std::vector<std::pair<fs::file_time_type, fs::directory_entry>> found;
+        std::error_code ec;
+        for (const auto& dir_entry : fs::directory_iterator(m_directory, ec))
+        {
+            if (dir_entry.path().extension() != cache_extension)
+            {
+                continue;
+            }
+            std::error_code time_ec;
+            auto time = dir_entry.last_write_time(time_ec);
+            if (!time_ec)
+            {
+                found.emplace_back(time, dir_entry);
+            }
+        }
+
+        // Oldest entries first, so that the most recently used end up at the
+        // front of the list.
+        std::sort(
+            found.begin(),
+            found.end(),
+            [](const auto& lhs, const auto& rhs)
+            {
+                return lhs.first < rhs.first;
+            }
+        );
+
+        for (const auto& [time, dir_entry] : found)
+        {
+            std::error_code size_ec;
+            std::uintmax_t entry_size = dir_entry.file_size(size_ec);
+            if (size_ec)
+            {
+                continue;
+            }
+            std::string key = dir_entry.path().stem().string();
+            m_lru.push_front(key);
+            m_entries[key] = entry{entry_size, m_lru.begin()};
+            m_size += entry_size;
+        }
+        evict();
+    }
+
+    void xcell_cache::touch(const std::string& key)
+    {
+        auto it = m_entries.find(key);
+        m_lru.splice(m_lru.begin(), m_lru, it->second.lru_it);
+
+        // The modification time carries the LRU order across kernel restarts.
+        std::error_code ec;
+        fs::last_write_time(entry_path(key), fs::file_time_type::clock::now(), ec);
+    }
+
+    void xcell_cache::evict()
+    {
+        while (m_size > m_max_size && !m_lru.empty())
+        {
+            remove(m_lru.back());
+        }
+    }
+
+    void xcell_cache::remove(const std::string& key)
+    {
+        auto it = m_entries.find(key);
+        if (it == m_entries.end())
+        {
+            return;
+        }
+        std::error_code ec;
+        fs::remove(entry_path(key), ec);
+        m_size -= it->second.size;
+        m_lru.erase(it->second.lru_it);
+        m_entries.erase(it);
+    }
+}
@@ -0,0 +1,82 @@
+/************************************************************************************
+ * Copyright (c) 2025, xeus-cpp contributors                                        *
+ *                                                                                  *
+ * Distributed under the terms of the BSD 3-Clause License.                         *
+ *                                                                                  *
+ * The full license is in the file LICENSE, distributed with this software.         *
+ ************************************************************************************/
+
+#ifndef XEUS_CPP_CACHE_HPP
+#define XEUS_CPP_CACHE_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <list>
+#include <string>
+#include <unordered_map>
+
+#include "xeus-cpp/xeus_cpp_config.hpp"
+
+namespace xcpp
+{
+    /****************
+     * xcell_cache *
+     ****************/
+
+    // Content-addressed on-disk store for per-cell compilation artifacts.
+    //
+    // A cell key chains the key of the previous successful cell, a digest of
+    // the interpreter flags and the cell text, so that a given key can only
+    // be reached by replaying the exact same sequence of cells in a kernel
+    // created with the same flags. Entries are evicted in least recently
+    // used order once the total size on disk exceeds the configured cap.
+    class XEUS_CPP_API xcell_cache
+    {
+    public:
+
+        xcell_cache(const std::string& directory, std::uintmax_t max_size);
+
+        static std::string digest(const std::string& data);
+        static std::string
+        make_key(const std::string& parent_key, const std::string& flags_digest, const std::string& code);
+
+        bool enabled() const;
+
+        bool lookup(const std::string& key, const std::string& code, std::string& payload);
+        void store(const std::string& key, const std::string& code, const std::string& payload);
+        void clear();
+
+        std::size_t hits() const;
+        std::size_t misses() const;
+        std::size_t entries() const;
+        std::uintmax_t size() const;
+        std::uintmax_t max_size() const;
+
+    private:
+
+        struct entry
+        {
+            std::uintmax_t size;
+            std::list<std::string>::iterator lru_it;
+        };
+
+        std::filesystem::path entry_path(const std::string& key) const;
+        void load_index();
+        void touch(const std::string& key);
+        void evict();
+        void remove(const std::string& key);
+
+        std::filesystem::path m_directory;
+        std::uintmax_t m_max_size;
+        std::uintmax_t m_size;
+        std::size_t m_hits;
+        std::size_t m_misses;
+
+        // Most recently used keys are at the front.
+        std::list<std::string> m_lru;
+        std::unordered_map<std::string, entry> m_entries;
+    };
+}
+
+#endif
@@ -0,0 +1,382 @@
+/************************************************************************************
+ * Copyright (c) 2025, xeus-cpp contributors                                        *
+ *                                                                                  *
+ * Distributed under the terms of the BSD 3-Clause License.                         *
+ *                                                                                  *
+ * The full license is in the file LICENSE, distributed with this software.         *
+ ************************************************************************************/
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include <nlohmann/json.hpp>
+
+#include <CppInterOp/CppInterOp.h>
+
+#include "xeus-cpp/xutils.hpp"
+
+#include "xcache.hpp"
+#include "xcompiler.hpp"
+
+#if !defined(_WIN32)
+#include <sys/wait.h>
+#include <unistd.h>
+#else
+#include <process.h>
+
+#include <random>
+#endif
+
+namespace fs = std::filesystem;
+namespace nl = nlohmann;
+
+namespace xcpp
+{
+    namespace
+    {
+        // Binaries spawned by Cpp::DetectResourceDir and
+        // Cpp::DetectSystemCompilerIncludePaths.
+        constexpr const char* resource_dir_compiler = "clang";
+        constexpr const char* system_includes_compiler = "c++";
+
+        nl::json compiler_signature(const std::string& name)
+        {
+            std::string path = find_program(name);
+            if (path.empty())
+            {
+                return nl::json();
+            }
+
+            std::error_code ec;
+            fs::path target = fs::canonical(path, ec);
+            if (ec)
+            {
+                target = path;
+            }
+            std::uintmax_t size = fs::file_size(target, ec);
+            if (ec)
+            {
+                return nl::json();
+            }
+            auto mtime = fs::last_write_time(target, ec);
+            if (ec)
+            {
+                return nl::json();
+            }
+            return {
+                {"name", name},
+                {"path", target.string()},
+                {"size", size},
+                {"mtime", static_cast<long long>(mtime.time_since_epoch().count())}
+            };
+        }
+
+        std::string cache_file()
+        {
+            std::string directory = retrieve_cache_dir();
+            return directory.empty() ? directory : directory + "/compiler-paths.json";
+        }
+
+        nl::json load_cache(const std::string& path)
+        {
+            std::ifstream in(path);
+            if (!in)
+            {
+                return nl::json::object();
+            }
+            nl::json content = nl::json::parse(in, nullptr, false);
+            return content.is_object() ? content : nl::json::object();
+        }
+
+        void save_cache(const std::string& path, const nl::json& content)
+        {
+            std::error_code ec;
+            fs::create_directories(fs::path(path).parent_path(), ec);
+
+            // Many kernels may start at the same time, write to a file of
+            // our own and rename it over the cache.
+#if defined(_WIN32)
+            std::string tmp_path = path + "." + std::to_string(_getpid()) + ".tmp";
+#else
+            std::string tmp_path = path + "." + std::to_string(getpid()) + ".tmp";
+#endif
+            {
+                std::ofstream out(tmp_path, std::ios::trunc);
+                if (!out)
+                {
+                    return;
+                }
+                out << content.dump(4);
+            }
+            fs::rename(tmp_path, path, ec);
+            if (ec)
+            {
+                fs::remove(tmp_path, ec);
+            }
+        }
+
+        std::string quote_argument(const std::string& arg)
+        {
+#if defined(_WIN32)
+            std::string res = "\"";
+            for (char c : arg)
+            {
+                res += c == '"' ? std::string("\\\"") : std::string(1, c);
+            }
+            return res + "\"";
+#else
+            std::string res = "'";
+            for (char c : arg)
+            {
+                res += c == '\'' ? std::string("'\\''") : std::string(1, c);
+            }
+            return res + "'";
+#endif
+        }
+
+        bool starts_with(const std::string& str, const std::string& prefix)
+        {
+            return str.compare(0, prefix.size(), prefix) == 0;
+        }
+    }
+
+    std::string find_program(const std::string& name)
+    {
+        const char* path_env = std::getenv("PATH");
+        if (path_env == nullptr)
+        {
+            return "";
+        }
+
+#if defined(_WIN32)
+        const char separator = ';';
+        const std::string suffix = ".exe";
+#else
+        const char separator = ':';
+        const std::string suffix = "";
+#endif
+
+        std::string path_list = path_env;
+        std::size_t start = 0;
+        while (start <= path_list.size())
+        {
+            std::size_t end = path_list.find(separator, start);
+            if (end == std::string::npos)
+            {
+                end = path_list.size();
+            }
+            std::string directory = path_list.substr(start, end - start);
+            if (!directory.empty())
+            {
+                fs::path candidate = fs::path(directory) / (name + suffix);
+                std::error_code ec;
+                if (fs::is_regular_file(candidate, ec))
+                {
+                    return candidate.string();
+                }
+            }
+            start = end + 1;
+        }
+        return "";
+    }
+
+    xcompiler_paths detect_compiler_paths(const std::vector<std::string>& flags, bool detect_resource_dir)
+    {
+        std::string key_data = detect_resource_dir ? "resource-dir" : "";
+        for (const std::string& flag : flags)
+        {
+            key_data.append(1, '\0').append(flag);
+        }
+        const std::string key = xcell_cache::digest(key_data);
+
+        nl::json signature = nl::json::array();
+        if (detect_resource_dir)
+        {
+            signature.push_back(compiler_signature(resource_dir_compiler));
+        }
+        signature.push_back(compiler_signature(system_includes_compiler));
+
+        const std::string path = cache_file();
+        const bool refresh = std::getenv("XCPP_REFRESH_COMPILER_CACHE") != nullptr;
+        nl::json cache = path.empty() ? nl::json::object() : load_cache(path);
+
+        xcompiler_paths res;
+        if (!refresh && cache.contains(key))
+        {
+            const nl::json& entry = cache[key];
+            if (entry.value("compilers", nl::json()) == signature)
+            {
+                res.resource_dir = entry.value("resource_dir", std::string());
+                res.system_includes = entry.value("system_includes", std::vector<std::string>());
+                return res;
+            }
+        }
+
+        if (detect_resource_dir)
+        {
+            res.resource_dir = Cpp::DetectResourceDir();
+        }
+        Cpp::DetectSystemCompilerIncludePaths(res.system_includes);
+
+        // A failed detection is retried at the next kernel start.
+        if (!path.empty() && (!detect_resource_dir || !res.resource_dir.empty()))
+        {
+            // Reload right before saving to lose as few entries as possible
+            // written by concurrent kernels.
+            cache = load_cache(path);
+            cache[key] = {
+                {"compilers", signature},
+                {"resource_dir", res.resource_dir},
+                {"system_includes", res.system_includes}
+            };
+            save_cache(path, cache);
+        }
+        return res;
+    }
+
+    std::string find_host_compiler()
+    {
+        if (const char* cxx = std::getenv("CXX"))
+        {
+            std::error_code ec;
+            if (fs::is_regular_file(cxx, ec))
+            {
+                return cxx;
+            }
+            std::string path = find_program(cxx);
+            if (!path.empty())
+            {
+                return path;
+            }
+        }
+        for (const char* name : {"clang++", "c++"})
+        {
+            std::string path = find_program(name);
+            if (!path.empty())
+            {
+                return path;
+            }
+        }
+        return "";
+    }
+
+    std::vector<std::string> host_compiler_flags(const std::vector<std::string>& interpreter_args)
+    {
+        // Options followed by a value in the next argument.
+        static const std::vector<std::string> kept_with_value = {
+            "-I", "-isystem", "-iquote", "-idirafter", "-include", "-D", "-U"
+        };
+        static const std::vector<std::string> dropped_with_value = {"-include-pch", "-resource-dir", "-Xclang"};
+        static const std::vector<std::string> kept_prefixes = {
+            "-I", "-isystem", "-iquote", "-D", "-U", "-std=", "-f", "-m", "-O"
+        };
+        // Only meaningful for the interpreter.
+        static const std::vector<std::string> dropped = {"-fincremental-extensions"};
+
+        auto contains = [](const std::vector<std::string>& list, const std::string& arg)
+        {
+            return std::find(list.begin(), list.end(), arg) != list.end();
+        };
+
+        std::vector<std::string> res;
+        for (std::size_t i = 0; i < interpreter_args.size(); ++i)
+        {
+            const std::string& arg = interpreter_args[i];
+            const bool has_value = i + 1 < interpreter_args.size();
+            if (contains(dropped_with_value, arg))
+            {
+                ++i;
+            }
+            else if (contains(kept_with_value, arg))
+            {
+                if (has_value)
+                {
+                    res.push_back(arg);
+                    res.push_back(interpreter_args[++i]);
+                }
+            }
+            else if (!contains(dropped, arg)
+                     && std::any_of(
+                         kept_prefixes.begin(),
+                         kept_prefixes.end(),
+                         [&arg](const std::string& prefix)
+                         {
+                             return starts_with(arg, prefix);
+                         }
+                     ))
+            {
+                res.push_back(arg);
+            }
+        }
+        return res;
+    }
+
+    int run_program(const std::vector<std::string>& args, std::string& output)
+    {
+        // Redirection of stderr to stdout, as for shell commands.
+        std::string command;
+        for (const std::string& arg : args)
+        {
+            command += quote_argument(arg) + " ";
+        }
+        command += "2>&1";
+#if defined(_WIN32)
+        // cmd.exe strips the outer quotes of the command line.
+        command = "\"" + command + "\"";
+        FILE* pipe = _popen(command.c_str(), "r");
+#else
+        FILE* pipe = popen(command.c_str(), "r");
+#endif
+        if (pipe == nullptr)
+        {
+            return -1;
+        }
+        char buffer[512];
+        while (std::fgets(buffer, sizeof(buffer), pipe))
+        {
+            output += buffer;
+        }
+#if defined(_WIN32)
+        return _pclose(pipe);
+#else
+        int status = pclose(pipe);
+        return (status != -1 && WIFEXITED(status)) ? WEXITSTATUS(status) : -1;
+#endif
+    }
+
+    std::string make_private_directory(const std::string& prefix)
+    {
+        std::error_code ec;
+        const fs::path temp = fs::temp_directory_path(ec);
+        if (ec)
+        {
+            return "";
+        }
+#if defined(_WIN32)
+        // The temporary directory is already private to the user.
+        std::random_device random;
+        for (int attempt = 0; attempt < 100; ++attempt)
+        {
+            const fs::path directory = temp / (prefix + std::to_string(random()));
+            if (fs::create_directory(directory, ec))
+            {
+                return directory.string();
+            }
+        }
+        return "";
+#else
+        // mkdtemp creates the directory with mode 0700.
+        std::string pattern = (temp / (prefix + "XXXXXX")).string();
+        if (mkdtemp(pattern.data()) == nullptr)
+        {
+            return "";
+        }
+        return pattern;
+#endif
+    }
+}
@@ -0,0 +1,59 @@
+/************************************************************************************
+ * Copyright (c) 2025, xeus-cpp contributors                                        *
+ *                                                                                  *
+ * Distributed under the terms of the BSD 3-Clause License.                         *
+ *                                                                                  *
+ * The full license is in the file LICENSE, distributed with this software.         *
+ ************************************************************************************/
+
+#ifndef XEUS_CPP_COMPILER_HPP
+#define XEUS_CPP_COMPILER_HPP
+
+#include <string>
+#include <vector>
+
+#include "xeus-cpp/xeus_cpp_config.hpp"
+
+namespace xcpp
+{
+    struct xcompiler_paths
+    {
+        std::string resource_dir;
+        std::vector<std::string> system_includes;
+    };
+
+    // Returns the resource directory and the system include paths of the host
+    // compiler. Spawning the compiler is expensive, the result is cached under
+    // the kernel cache directory and reused as long as the compiler binaries
+    // and the flags are unchanged. Setting XCPP_REFRESH_COMPILER_CACHE forces
+    // a new detection.
+    XEUS_CPP_API
+    xcompiler_paths detect_compiler_paths(const std::vector<std::string>& flags, bool detect_resource_dir);
+
+    XEUS_CPP_API
+    std::string find_program(const std::string& name);
+
+    // Returns the compiler used to build code ahead of time: $CXX if set,
+    // otherwise clang++ or c++ found in PATH.
+    XEUS_CPP_API
+    std::string find_host_compiler();
+
+    // Selects the interpreter flags that also apply to the host compiler:
+    // include paths, macros, language standard, code generation options.
+    XEUS_CPP_API
+    std::vector<std::string> host_compiler_flags(const std::vector<std::string>& interpreter_args);
+
+    // Runs a program and collects its standard output and error. Returns its
+    // exit status, or -1 if it could not be started.
+    XEUS_CPP_API
+    int run_program(const std::vector<std::string>& args, std::string& output);
+
+    // Creates a directory with an unpredictable name, only accessible to the
+    // current user, in the temporary directory. The files built there cannot
+    // be planted or replaced by other users before they are loaded. Returns
+    // its path, or an empty string on failure.
+    XEUS_CPP_API
+    std::string make_private_directory(const std::string& prefix);
+}
+
+#endif
@@ -0,0 +1,262 @@
+/************************************************************************************
+ * Copyright (c) 2025, xeus-cpp contributors                                        *
+ *                                                                                  *
+ * Distributed under the terms of the BSD 3-Clause License.                         *
+ *                                                                                  *
+ * The full license is in the file LICENSE, distributed with this software.         *
+ ************************************************************************************/
+
+#include <algorithm>
+#include <string>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+#include "xcompletion.hpp"
+
+#if !defined(_WIN32) && !defined(__EMSCRIPTEN__)
+#include <pthread.h>
+#define XEUS_CPP_COMPLETION_PTHREAD
+#elif !defined(__EMSCRIPTEN__)
+#include <thread>
+#endif
+
+namespace xcpp
+{
+    xcompletion_cache::xcompletion_cache(std::size_t capacity)
+        : m_capacity(std::max<std::size_t>(capacity, 1))
+        , m_generation(0)
+        , m_hits(0)
+        , m_misses(0)
+    {
+    }
+
+    void xcompletion_cache::invalidate()
+    {
+        ++m_generation;
+        m_entries.clear();
+        m_lru.clear();
+    }
+
+    std::uint64_t xcompletion_cache::generation() const
+    {
+        return m_generation;
+    }
+
+    bool xcompletion_cache::lookup(
+        const std::string& context,
+        const std::string& token,
+        std::vector<std::string>& results
+    )
+    {
+        auto it = m_entries.find(make_key(context));
+        // Candidates of a longer token miss some of those of this one.
+        if (it == m_entries.end() || token.compare(0, it->second.token.size(), it->second.token) != 0)
+        {
+            ++m_misses;
+            return false;
+        }
+        ++m_hits;
+        m_lru.splice(m_lru.begin(), m_lru, it->second.lru_it);
+        results = it->second.results;
+        filter(token, results);
+        return true;
+    }
+
+    void xcompletion_cache::store(
+        const std::string& context,
+        const std::string& token,
+        const std::vector<std::string>& results
+    )
+    {
+        std::string key = make_key(context);
+        auto it = m_entries.find(key);
+        if (it != m_entries.end())
+        {
+            it->second.token = token;
+            it->second.results = results;
+            m_lru.splice(m_lru.begin(), m_lru, it->second.lru_it);
+            return;
+        }
+        if (m_entries.size() >= m_capacity)
+        {
+            m_entries.erase(m_lru.back());
+            m_lru.pop_back();
+        }
+        m_lru.push_front(key);
+        m_entries.emplace(std::move(key), entry{token, results, m_lru.begin()});
+    }
+
+    void xcompletion_cache::filter(const std::string& token, std::vector<std::string>& results)
+    {
+        // Clang's order is kept, only the duplicates after the first
+        // occurrence are dropped.
+        std::unordered_set<std::string> seen;
+        results.erase(
+            std::remove_if(
+                results.begin(),
+                results.end(),
+                [&token, &seen](const std::string& result)
+                {
+                    return result.compare(0, token.size(), token) != 0 || !seen.insert(result).second;
+                }
+            ),
+            results.end()
+        );
+    }
+
+    std::size_t xcompletion_cache::hits() const
+    {
+        return m_hits;
+    }
+
+    std::size_t xcompletion_cache::misses() const
+    {
+        return m_misses;
+    }
+
+    std::size_t xcompletion_cache::entries() const
+    {
+        return m_entries.size();
+    }
+
+    std::string xcompletion_cache::make_key(const std::string& context) const
+    {
+        return std::to_string(m_generation) + '\n' + context;
+    }
+
+    /***********************************
+     * xcompletion_task implementation *
+     ***********************************/
+
+#if defined(XEUS_CPP_COMPLETION_PTHREAD)
+
+    struct xcompletion_task::thread
+    {
+        // Default stack size of the main thread on Linux, secondary threads
+        // may get much less, e.g. 512 KB on macOS.
+        static constexpr std::size_t stack_size = 8 * 1024 * 1024;
+
+        thread(std::function<void()> function)
+            : m_function(std::move(function))
+            , m_started(false)
+        {
+            pthread_attr_t attributes;
+            pthread_attr_init(&attributes);
+            pthread_attr_setstacksize(&attributes, stack_size);
+            m_started = pthread_create(&m_handle, &attributes, &thread::run, this) == 0;
+            pthread_attr_destroy(&attributes);
+            if (!m_started)
+            {
+                m_function();
+            }
+        }
+
+        ~thread()
+        {
+            if (m_started)
+            {
+                pthread_join(m_handle, nullptr);
+            }
+        }
+
+        static void* run(void* self)
+        {
+            static_cast<thread*>(self)->m_function();
+            return nullptr;
+        }
+
+        std::function<void()> m_function;
+        pthread_t m_handle;
+        bool m_started;
+    };
+
+#elif !defined(__EMSCRIPTEN__)
+
+    struct xcompletion_task::thread
+    {
+        thread(std::function<void()> function)
+            : m_thread(std::move(function))
+        {
+        }
+
+        ~thread()
+        {
+            m_thread.join();
+        }
+
+        std::thread m_thread;
+    };
+
+#else
+
+    // Without threads, the completion runs synchronously.
+    struct xcompletion_task::thread
+    {
+        thread(std::function<void()> function)
+        {
+            function();
+        }
+    };
+
+#endif
+
+    xcompletion_task::xcompletion_task(std::string context, std::string token, function_type function)
+        : m_context(std::move(context))
+        , m_token(std::move(token))
+        , p_state(std::make_shared<state>())
+    {
+        p_thread = std::make_unique<thread>(
+            [state = p_state, function = std::move(function)]
+            {
+                std::vector<std::string> results;
+                try
+                {
+                    results = function();
+                }
+                catch (...)
+                {
+                }
+                std::lock_guard<std::mutex> lock(state->mutex);
+                state->results = std::move(results);
+                state->done = true;
+                state->cv.notify_all();
+            }
+        );
+    }
+
+    xcompletion_task::~xcompletion_task()
+    {
+        p_thread.reset();
+    }
+
+    const std::string& xcompletion_task::context() const
+    {
+        return m_context;
+    }
+
+    const std::string& xcompletion_task::token() const
+    {
+        return m_token;
+    }
+
+    bool xcompletion_task::wait_for(std::chrono::milliseconds timeout)
+    {
+        std::unique_lock<std::mutex> lock(p_state->mutex);
+        return p_state->cv.wait_for(
+            lock,
+            timeout,
+            [this]
+            {
+                return p_state->done;
+            }
+        );
+    }
+
+    std::vector<std::string> xcompletion_task::get()
+    {
+        p_thread.reset();
+        std::lock_guard<std::mutex> lock(p_state->mutex);
+        return std::move(p_state->results);
+    }
+}
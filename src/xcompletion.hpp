@@ -0,0 +1,129 @@
+/************************************************************************************
+ * Copyright (c) 2025, xeus-cpp contributors                                        *
+ *                                                                                  *
+ * Distributed under the terms of the BSD 3-Clause License.                         *
+ *                                                                                  *
+ * The full license is in the file LICENSE, distributed with this software.         *
+ ************************************************************************************/
+
+#ifndef XEUS_CPP_COMPLETION_HPP
+#define XEUS_CPP_COMPLETION_HPP
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "xeus-cpp/xeus_cpp_config.hpp"
+
+namespace xcpp
+{
+    /*********************
+     * xcompletion_cache *
+     *********************/
+
+    // In-memory cache of the completion candidates returned by Clang.
+    //
+    // Entries are keyed by the code preceding the token being completed and
+    // by the generation of the interpreter, which changes with every
+    // executed cell. The candidates of an entry are those of a prefix of the
+    // token: typing more characters of the same identifier filters them
+    // instead of parsing the cell again. The least recently used entries are
+    // evicted beyond the capacity.
+    class XEUS_CPP_API xcompletion_cache
+    {
+    public:
+
+        explicit xcompletion_cache(std::size_t capacity = 32);
+
+        // Drops all entries, the declarations of the interpreter changed.
+        void invalidate();
+        std::uint64_t generation() const;
+
+        bool lookup(const std::string& context, const std::string& token, std::vector<std::string>& results);
+        void store(const std::string& context, const std::string& token, const std::vector<std::string>& results);
+
+        // Keeps the candidates starting with `token`, without duplicates, in
+        // the order Clang returned them.
+        static void filter(const std::string& token, std::vector<std::string>& results);
+
+        std::size_t hits() const;
+        std::size_t misses() const;
+        std::size_t entries() const;
+
+    private:
+
+        struct entry
+        {
+            std::string token;
+            std::vector<std::string> results;
+            std::list<std::string>::iterator lru_it;
+        };
+
+        std::string make_key(const std::string& context) const;
+
+        std::size_t m_capacity;
+        std::uint64_t m_generation;
+        std::size_t m_hits;
+        std::size_t m_misses;
+
+        // Most recently used keys are at the front.
+        std::list<std::string> m_lru;
+        std::unordered_map<std::string, entry> m_entries;
+    };
+
+    /********************
+     * xcompletion_task *
+     ********************/
+
+    // Completion running on a thread of its own, so that the request can be
+    // answered when it exceeds its time budget. Clang cannot stop a
+    // completion: the task runs to the end, and the interpreter must not be
+    // used by another thread until it is done. The thread has the stack size
+    // of a main thread, parsing may recurse deeply.
+    class XEUS_CPP_API xcompletion_task
+    {
+    public:
+
+        using function_type = std::function<std::vector<std::string>()>;
+
+        xcompletion_task(std::string context, std::string token, function_type function);
+        ~xcompletion_task();
+
+        xcompletion_task(const xcompletion_task&) = delete;
+        xcompletion_task& operator=(const xcompletion_task&) = delete;
+
+        const std::string& context() const;
+        const std::string& token() const;
+
+        bool wait_for(std::chrono::milliseconds timeout);
+        // Waits for the task and returns its candidates.
+        std::vector<std::string> get();
+
+    private:
+
+        struct state
+        {
+            std::mutex mutex;
+            std::condition_variable cv;
+            bool done = false;
+            std::vector<std::string> results;
+        };
+
+        struct thread;
+
+        std::string m_context;
+        std::string m_token;
+        std::shared_ptr<state> p_state;
+        std::unique_ptr<thread> p_thread;
+    };
+}
+
+#endif
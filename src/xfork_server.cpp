@@ -0,0 +1,474 @@
+/************************************************************************************
+ * Copyright (c) 2025, xeus-cpp contributors                                        *
+ *                                                                                  *
+ * Distributed under the terms of the BSD 3-Clause License.                         *
+ *                                                                                  *
+ * The full license is in the file LICENSE, distributed with this software.         *
+ ************************************************************************************/
+
+#include <algorithm>
+#include <cerrno>
+#include <csignal>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <pthread.h>
+#include <signal.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include "xfork_server.hpp"
+
+namespace fs = std::filesystem;
+
+namespace xcpp
+{
+    namespace
+    {
+        // The client sends its working directory and the connection file,
+        // each terminated by a newline, along with its standard streams.
+        constexpr std::size_t max_request_size = 8192;
+        constexpr int forwarded_fd_count = 3;
+
+        volatile sig_atomic_t kernel_pid = 0;
+
+        bool make_address(const std::string& socket_path, sockaddr_un& address)
+        {
+            std::memset(&address, 0, sizeof(address));
+            address.sun_family = AF_UNIX;
+            if (socket_path.size() >= sizeof(address.sun_path))
+            {
+                std::cerr << "Fork server socket path is too long: " << socket_path << std::endl;
+                return false;
+            }
+            std::memcpy(address.sun_path, socket_path.c_str(), socket_path.size() + 1);
+            return true;
+        }
+
+        // Only a stale socket left by the same user is removed, anything else
+        // at `socket_path` may belong to someone else.
+        bool remove_stale_socket(const std::string& socket_path)
+        {
+            struct stat info;
+            if (::lstat(socket_path.c_str(), &info) < 0)
+            {
+                if (errno == ENOENT)
+                {
+                    return true;
+                }
+                std::cerr << "Could not inspect " << socket_path << ": " << std::strerror(errno) << std::endl;
+                return false;
+            }
+            if (!S_ISSOCK(info.st_mode) || info.st_uid != ::geteuid())
+            {
+                std::cerr << "Refusing to replace " << socket_path
+                          << ", which is not a socket owned by the current user" << std::endl;
+                return false;
+            }
+            ::unlink(socket_path.c_str());
+            return true;
+        }
+
+        bool peer_uid(int fd, uid_t& uid)
+        {
+#if defined(__linux__)
+            ucred credentials;
+            socklen_t size = sizeof(credentials);
+            if (::getsockopt(fd, SOL_SOCKET, SO_PEERCRED, &credentials, &size) < 0)
+            {
+                return false;
+            }
+            uid = credentials.uid;
+            return true;
+#else
+            gid_t gid;
+            return ::getpeereid(fd, &uid, &gid) == 0;
+#endif
+        }
+
+        // The kernel runs arbitrary code as the owner of the server, it must
+        // only be handed to that same user.
+        bool is_same_user(int fd)
+        {
+            uid_t uid;
+            return peer_uid(fd, uid) && uid == ::geteuid();
+        }
+
+        bool write_all(int fd, const std::string& data)
+        {
+            std::size_t written = 0;
+            while (written < data.size())
+            {
+                ssize_t n = ::write(fd, data.data() + written, data.size() - written);
+                if (n < 0 && errno == EINTR)
+                {
+                    continue;
+                }
+                if (n <= 0)
+                {
+                    return false;
+                }
+                written += static_cast<std::size_t>(n);
+            }
+            return true;
+        }
+
+        bool send_request(int fd, const std::string& request)
+        {
+            int fds[forwarded_fd_count] = {STDIN_FILENO, STDOUT_FILENO, STDERR_FILENO};
+            char control[CMSG_SPACE(sizeof(fds))];
+            std::memset(control, 0, sizeof(control));
+
+            iovec iov;
+            iov.iov_base = const_cast<char*>(request.data());
+            iov.iov_len = request.size();
+
+            msghdr msg;
+            std::memset(&msg, 0, sizeof(msg));
+            msg.msg_iov = &iov;
+            msg.msg_iovlen = 1;
+            msg.msg_control = control;
+            msg.msg_controllen = sizeof(control);
+
+            cmsghdr* cmsg = CMSG_FIRSTHDR(&msg);
+            cmsg->cmsg_level = SOL_SOCKET;
+            cmsg->cmsg_type = SCM_RIGHTS;
+            cmsg->cmsg_len = CMSG_LEN(sizeof(fds));
+            std::memcpy(CMSG_DATA(cmsg), fds, sizeof(fds));
+
+            ssize_t n;
+            do
+            {
+                n = ::sendmsg(fd, &msg, 0);
+            } while (n < 0 && errno == EINTR);
+            if (n != static_cast<ssize_t>(request.size()))
+            {
+                return false;
+            }
+            return true;
+        }
+
+        // Reads the request sent by `send_request`. The streams of the client
+        // are stored in `fds`, set to -1 when missing.
+        bool receive_request(int fd, std::string& request, int (&fds)[forwarded_fd_count])
+        {
+            for (int& received : fds)
+            {
+                received = -1;
+            }
+
+            std::vector<char> buffer(max_request_size);
+            char control[CMSG_SPACE(sizeof(fds))];
+
+            iovec iov;
+            iov.iov_base = buffer.data();
+            iov.iov_len = buffer.size();
+
+            msghdr msg;
+            std::memset(&msg, 0, sizeof(msg));
+            msg.msg_iov = &iov;
+            msg.msg_iovlen = 1;
+            msg.msg_control = control;
+            msg.msg_controllen = sizeof(control);
+
+            ssize_t n;
+            do
+            {
+                n = ::recvmsg(fd, &msg, 0);
+            } while (n < 0 && errno == EINTR);
+            if (n <= 0)
+            {
+                return false;
+            }
+
+            for (cmsghdr* cmsg = CMSG_FIRSTHDR(&msg); cmsg != nullptr; cmsg = CMSG_NXTHDR(&msg, cmsg))
+            {
+                if (cmsg->cmsg_level == SOL_SOCKET && cmsg->cmsg_type == SCM_RIGHTS)
+                {
+                    std::size_t count = (cmsg->cmsg_len - CMSG_LEN(0)) / sizeof(int);
+                    std::memcpy(fds, CMSG_DATA(cmsg), std::min<std::size_t>(count, forwarded_fd_count) * sizeof(int));
+                }
+            }
+            request.assign(buffer.data(), static_cast<std::size_t>(n));
+            return true;
+        }
+
+        void close_fds(int (&fds)[forwarded_fd_count])
+        {
+            for (int& fd : fds)
+            {
+                if (fd >= 0)
+                {
+                    ::close(fd);
+                    fd = -1;
+                }
+            }
+        }
+
+        // Runs in the forked child: takes over the streams and the working
+        // directory of the client, then ties the lifetime of the kernel to
+        // the connection so that a killed client does not leave an orphan.
+        void adopt_client(int connection, int (&fds)[forwarded_fd_count], const std::string& cwd)
+        {
+            for (int i = 0; i < forwarded_fd_count; ++i)
+            {
+                if (fds[i] >= 0)
+                {
+                    ::dup2(fds[i], i);
+                }
+            }
+            close_fds(fds);
+
+            std::error_code ec;
+            fs::current_path(cwd, ec);
+            if (ec)
+            {
+                std::cerr << "Could not change directory to " << cwd << ": " << ec.message() << std::endl;
+            }
+
+            write_all(connection, std::to_string(::getpid()) + "\n");
+
+            std::thread(
+                [connection]()
+                {
+                    char c;
+                    ssize_t n;
+                    do
+                    {
+                        n = ::read(connection, &c, 1);
+                    } while (n > 0 || (n < 0 && errno == EINTR));
+                    ::_exit(0);
+                }
+            ).detach();
+        }
+
+        void forward_signal(int sig)
+        {
+            if (kernel_pid > 0)
+            {
+                ::kill(static_cast<pid_t>(kernel_pid), sig);
+            }
+        }
+    }
+
+    std::vector<std::string> extract_option(int& argc, char* argv[], const std::string& name)
+    {
+        std::vector<std::string> res;
+        int j = 1;
+        for (int i = 1; i < argc; ++i)
+        {
+            if (name == argv[i] && i + 1 < argc)
+            {
+                res.push_back(argv[++i]);
+            }
+            else
+            {
+                argv[j++] = argv[i];
+            }
+        }
+        argc = j;
+        argv[argc] = nullptr;
+        return res;
+    }
+
+    int run_fork_server(
+        const std::string& socket_path,
+        std::unique_ptr<interpreter> warm_interpreter,
+        const kernel_launcher& launch
+    )
+    {
+        sockaddr_un address;
+        if (!make_address(socket_path, address))
+        {
+            return 1;
+        }
+
+        int listener = ::socket(AF_UNIX, SOCK_STREAM, 0);
+        if (listener < 0)
+        {
+            std::cerr << "Could not create fork server socket: " << std::strerror(errno) << std::endl;
+            return 1;
+        }
+        if (!remove_stale_socket(socket_path))
+        {
+            ::close(listener);
+            return 1;
+        }
+
+        // The socket is created readable and writable by its owner only.
+        mode_t previous_mask = ::umask(0077);
+        int bound = ::bind(listener, reinterpret_cast<sockaddr*>(&address), sizeof(address));
+        ::umask(previous_mask);
+        if (bound < 0 || ::chmod(socket_path.c_str(), S_IRUSR | S_IWUSR) < 0
+            || ::listen(listener, SOMAXCONN) < 0)
+        {
+            std::cerr << "Could not listen on " << socket_path << ": " << std::strerror(errno) << std::endl;
+            ::close(listener);
+            return 1;
+        }
+
+        // Children are never waited for, let the system reap them.
+        std::signal(SIGCHLD, SIG_IGN);
+        std::clog << "xcpp fork server listening on " << socket_path << std::endl;
+
+        while (true)
+        {
+            int connection = ::accept(listener, nullptr, nullptr);
+            if (connection < 0)
+            {
+                if (errno == EINTR || errno == ECONNABORTED)
+                {
+                    continue;
+                }
+                std::cerr << "Fork server stopped: " << std::strerror(errno) << std::endl;
+                break;
+            }
+            if (!is_same_user(connection))
+            {
+                std::cerr << "Fork server rejected a connection from another user" << std::endl;
+                ::close(connection);
+                continue;
+            }
+
+            std::string request;
+            int fds[forwarded_fd_count];
+            if (!receive_request(connection, request, fds))
+            {
+                close_fds(fds);
+                ::close(connection);
+                continue;
+            }
+
+            std::size_t separator = request.find('\n');
+            std::size_t end = request.find('\n', separator == std::string::npos ? 0 : separator + 1);
+            if (separator == std::string::npos || end == std::string::npos)
+            {
+                std::cerr << "Fork server received a malformed request" << std::endl;
+                close_fds(fds);
+                ::close(connection);
+                continue;
+            }
+            std::string cwd = request.substr(0, separator);
+            std::string connection_file = request.substr(separator + 1, end - separator - 1);
+
+            pid_t pid = ::fork();
+            if (pid == 0)
+            {
+                ::close(listener);
+                std::signal(SIGCHLD, SIG_DFL);
+                // SIGINT interrupts the cell once the kernel has started. It
+                // is blocked before adopt_client starts its thread, which
+                // would otherwise receive it with the default action.
+                sigset_t interrupt;
+                sigemptyset(&interrupt);
+                sigaddset(&interrupt, SIGINT);
+                ::pthread_sigmask(SIG_BLOCK, &interrupt, nullptr);
+                adopt_client(connection, fds, cwd);
+                launch(connection_file, std::move(warm_interpreter));
+                return 0;
+            }
+            if (pid < 0)
+            {
+                std::cerr << "Could not fork a kernel: " << std::strerror(errno) << std::endl;
+            }
+            close_fds(fds);
+            ::close(connection);
+        }
+
+        ::close(listener);
+        ::unlink(socket_path.c_str());
+        return 1;
+    }
+
+    int run_fork_client(const std::string& socket_path, const std::string& connection_file)
+    {
+        sockaddr_un address;
+        if (!make_address(socket_path, address))
+        {
+            return 1;
+        }
+
+        int connection = ::socket(AF_UNIX, SOCK_STREAM, 0);
+        if (connection < 0
+            || ::connect(connection, reinterpret_cast<sockaddr*>(&address), sizeof(address)) < 0)
+        {
+            std::cerr << "Could not connect to the fork server on " << socket_path << ": "
+                      << std::strerror(errno) << std::endl;
+            return 1;
+        }
+        if (!is_same_user(connection))
+        {
+            std::cerr << "The fork server on " << socket_path << " belongs to another user" << std::endl;
+            ::close(connection);
+            return 1;
+        }
+
+        // The connection file is usually given relative to the directory
+        // the kernel is started in, which the child moves to.
+        std::error_code ec;
+        std::string cwd = fs::current_path(ec).string();
+        std::string request = cwd + "\n" + fs::absolute(connection_file, ec).string() + "\n";
+        if (!send_request(connection, request))
+        {
+            std::cerr << "Could not send the kernel request to the fork server" << std::endl;
+            ::close(connection);
+            return 1;
+        }
+
+        std::string reply;
+        char c;
+        ssize_t n;
+        while ((n = ::read(connection, &c, 1)) != 0)
+        {
+            if (n < 0)
+            {
+                if (errno == EINTR)
+                {
+                    continue;
+                }
+                break;
+            }
+            if (c == '\n')
+            {
+                break;
+            }
+            reply.push_back(c);
+        }
+        char* end = nullptr;
+        errno = 0;
+        long pid = std::strtol(reply.c_str(), &end, 10);
+        if (reply.empty() || *end != '\0' || errno != 0 || pid <= 0)
+        {
+            std::cerr << "The fork server did not start a kernel" << std::endl;
+            ::close(connection);
+            return 1;
+        }
+        kernel_pid = static_cast<sig_atomic_t>(pid);
+
+        // Jupyter interrupts and stops the process it launched.
+        for (int sig : {SIGINT, SIGTERM, SIGHUP, SIGQUIT})
+        {
+            std::signal(sig, forward_signal);
+        }
+
+        // The kernel holds the other end of the connection until it exits.
+        char buffer[64];
+        do
+        {
+            n = ::read(connection, buffer, sizeof(buffer));
+        } while (n > 0 || (n < 0 && errno == EINTR));
+
+        ::close(connection);
+        return 0;
+    }
+}
@@ -0,0 +1,43 @@
+/************************************************************************************
+ * Copyright (c) 2025, xeus-cpp contributors                                        *
+ *                                                                                  *
+ * Distributed under the terms of the BSD 3-Clause License.                         *
+ *                                                                                  *
+ * The full license is in the file LICENSE, distributed with this software.         *
+ ************************************************************************************/
+
+#ifndef XEUS_CPP_FORK_SERVER_HPP
+#define XEUS_CPP_FORK_SERVER_HPP
+
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "xeus-cpp/xinterpreter.hpp"
+
+namespace xcpp
+{
+    using kernel_launcher = std::function<void(const std::string&, std::unique_ptr<interpreter>)>;
+
+    // Removes every occurrence of `name <value>` from argv and returns the
+    // values in order.
+    std::vector<std::string> extract_option(int& argc, char* argv[], const std::string& name);
+
+    // Serves kernel launch requests on a unix socket. The interpreter is
+    // initialized once, each request forks a child that inherits its state
+    // through copy-on-write pages and runs `launch` with the connection file
+    // sent by the client. Only returns in the children, or on error.
+    int run_fork_server(
+        const std::string& socket_path,
+        std::unique_ptr<interpreter> warm_interpreter,
+        const kernel_launcher& launch
+    );
+
+    // Asks the fork server listening on `socket_path` to start a kernel for
+    // `connection_file`, forwards the termination and interruption signals
+    // to it and returns when it exits.
+    int run_fork_client(const std::string& socket_path, const std::string& connection_file);
+}
+
+#endif
@@ -23,6 +23,21 @@ namespace xcpp
         throw std::runtime_error("This frontend does not support input requests");
     }
 
+    namespace
+    {
+        // The prompt may be held back by the coalescing of the output.
+        void flush_output()
+        {
+            for (std::ostream* stream : {&std::cout, &std::cerr})
+            {
+                if (auto* buffer = dynamic_cast<xoutput_buffer*>(stream->rdbuf()))
+                {
+                    buffer->flush_pending();
+                }
+            }
+        }
+    }
+
     /***************************************
      * Implementation of input_redirection *
      ***************************************/
@@ -33,6 +48,7 @@ namespace xcpp
               allow_stdin ? xinput_buffer(
                   [](std::string& value)
                   {
+                      flush_output();
                       value = xeus::blocking_input_request("", false);
                   }
               )
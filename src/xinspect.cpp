@@ -9,14 +9,21 @@
 #include <filesystem>
 #include <fstream>
 #include <iostream>
+#include <memory>
+#include <mutex>
 #include <regex>
 #include <string>
+#include <system_error>
+#include <unordered_map>
 #include <utility>
 #include <vector>
 
 #include "xeus/xhelper.hpp"
 
 #include "xinspect.hpp"
+#include "xlocal_docs.hpp"
+#include "xsymbol_index.hpp"
+#include "xtagfile_index.hpp"
 
 #include <CppInterOp/CppInterOp.h>
 
@@ -66,15 +73,87 @@ namespace xcpp
 
     namespace
     {
-        std::string find_type_slow(const std::string& expression)
+        // Resolved types by expression, cleared when the cells change the
+        // declarations. Failures are cached as empty strings.
+        constexpr std::size_t type_cache_capacity = 256;
+
+        std::unordered_map<std::string, std::string>& type_cache()
+        {
+            static std::unordered_map<std::string, std::string> cache;
+            return cache;
+        }
+
+        // The index of the installed tagfiles is opened on first use and
+        // again when the directory of their configurations or the compiled
+        // index is modified, or the directories change. The compiled index
+        // is only used if it is not older than the configurations, otherwise
+        // the tagfiles are parsed.
+        std::shared_ptr<const xtagfile_index> tagfile_index()
         {
-            static unsigned long long var_count = 0;
+            static std::mutex mutex;
+            static std::shared_ptr<const xtagfile_index> index;
+            static std::string directories;
+            static std::filesystem::file_time_type conf_time;
+            static std::filesystem::file_time_type compiled_time;
 
-            if (auto* type = Cpp::GetType(expression))
+            const std::string tagconf_dir = retrieve_tagconf_dir();
+            const std::string tagfile_dir = retrieve_tagfile_dir();
+            const std::string compiled = tagfile_dir + "/" + compiled_tagfile_index;
+            std::error_code ec;
+            const auto conf = std::filesystem::last_write_time(tagconf_dir, ec);
+            const auto time = std::filesystem::last_write_time(compiled, ec);
+            const bool use_compiled = !ec && time >= conf;
+
+            std::lock_guard<std::mutex> lock(mutex);
+            if (!index || directories != tagconf_dir + '\0' + tagfile_dir || conf != conf_time
+                || time != compiled_time)
             {
-                return Cpp::GetQualifiedName(type);
+                auto res = std::make_shared<xtagfile_index>();
+                if (!use_compiled || !res->open(compiled))
+                {
+                    *res = xtagfile_index::load(tagconf_dir, tagfile_dir);
+                }
+                index = std::move(res);
+                directories = tagconf_dir + '\0' + tagfile_dir;
+                conf_time = conf;
+                compiled_time = time;
             }
+            return index;
+        }
+    }
+
+    nl::json local_docs_data(const std::string& url)
+    {
+        static std::mutex mutex;
+        static std::unique_ptr<xlocal_docs> docs;
+
+        const std::string directory = retrieve_docs_dir();
+        std::lock_guard<std::mutex> lock(mutex);
+        if (!docs || docs->directory() != directory)
+        {
+            docs = std::make_unique<xlocal_docs>(directory);
+        }
+        return docs->lookup(url);
+    }
+
+    std::string find_type_slow(const std::string& expression)
+    {
+        static unsigned long long var_count = 0;
+
+        auto& cache = type_cache();
+        auto it = cache.find(expression);
+        if (it != cache.end())
+        {
+            return it->second;
+        }
 
+        std::string res;
+        if (auto* type = Cpp::GetType(expression))
+        {
+            res = Cpp::GetQualifiedName(type);
+        }
+        else
+        {
             std::string id = "__Xeus_GetType_" + std::to_string(var_count++);
             std::string using_clause = "using " + id + " = __typeof__(" + expression + ");\n";
 
@@ -82,34 +161,29 @@ namespace xcpp
             {
                 Cpp::TCppScope_t lookup = Cpp::GetNamed(id, nullptr);
                 Cpp::TCppType_t lookup_ty = Cpp::GetTypeFromScope(lookup);
-                return Cpp::GetQualifiedCompleteName(Cpp::GetCanonicalType(lookup_ty));
+                res = Cpp::GetQualifiedCompleteName(Cpp::GetCanonicalType(lookup_ty));
+                // The alias is only needed for the lookup, undoing its
+                // transaction keeps inspection from growing the interpreter.
+                Cpp::Undo(1);
             }
-            return "";
         }
 
-        nl::json read_tagconfs(const char* path)
+        if (cache.size() >= type_cache_capacity)
         {
-            nl::json result = nl::json::array();
-            for (const auto& entry : std::filesystem::directory_iterator(path))
-            {
-                if (entry.path().extension() != ".json")
-                {
-                    continue;
-                }
-                std::ifstream i(entry.path());
-                nl::json json_entry;
-                i >> json_entry;
-                result.emplace_back(std::move(json_entry));
-            }
-            return result;
+            cache.clear();
         }
+        cache.emplace(expression, res);
+        return res;
+    }
+
+    void clear_type_cache()
+    {
+        type_cache().clear();
     }
 
     std::string inspect(const std::string& code)
     {
-        std::string tagconf_dir = retrieve_tagconf_dir();
-        std::string tagfiles_dir = retrieve_tagfile_dir();
-        nl::json tagconfs = read_tagconfs(tagconf_dir.c_str());
+        std::shared_ptr<const xtagfile_index> index = tagfile_index();
 
         std::regex re_expression(R"(([^\s]+(?:\s*\([^)]+\))?))");
 
@@ -128,20 +202,7 @@ namespace xcpp
 
             if (!type_name.empty())
             {
-                for (nl::json::const_iterator it = tagconfs.cbegin(); it != tagconfs.cend(); ++it)
-                {
-                    std::string url = it->at("url");
-                    std::string tagfile = it->at("tagfile");
-                    std::string filename = tagfiles_dir + "/" + tagfile;
-                    pugi::xml_document doc;
-                    pugi::xml_parse_result result = doc.load_file(filename.c_str());
-                    class_member_predicate predicate{type_name, "function", method[2]};
-                    auto node = doc.find_node(predicate);
-                    if (!node.empty())
-                    {
-                        inspect_result = url + predicate.get_filename(node);
-                    }
-                }
+                inspect_result = index->find_member(type_name, "function", method[2]);
             }
         }
         else
@@ -162,32 +223,14 @@ namespace xcpp
                 find_string = (type_name.empty()) ? to_inspect : type_name;
             }
 
-            const std::vector<std::string> check{"class", "struct", "function"};
-            for (nl::json::const_iterator it = tagconfs.cbegin(); it != tagconfs.cend(); ++it)
+            // A function documented under the same name as a class takes
+            // precedence over it.
+            for (const char* kind : {"function", "struct", "class"})
             {
-                std::string url = it->at("url");
-                std::string tagfile = it->at("tagfile");
-                std::string filename = tagfiles_dir + "/" + tagfile;
-                pugi::xml_document doc;
-                pugi::xml_parse_result result = doc.load_file(filename.c_str());
-                for (auto c : check)
+                inspect_result = index->find(kind, find_string);
+                if (!inspect_result.empty())
                 {
-                    node_predicate predicate{c, find_string};
-                    std::string node;
-
-                    if (c == "class" || c == "struct")
-                    {
-                        node = doc.find_node(predicate).child("filename").child_value();
-                    }
-                    else
-                    {
-                        node = doc.find_node(predicate).child("anchorfile").child_value();
-                    }
-
-                    if (!node.empty())
-                    {
-                        inspect_result = url + node;
-                    }
+                    break;
                 }
             }
         }
@@ -197,6 +240,13 @@ namespace xcpp
 
     nl::json build_inspect_data(const std::string& inspect_result)
     {
+        // A local copy of the page is embedded instead of the remote page.
+        nl::json local = local_docs_data(inspect_result);
+        if (!local.empty())
+        {
+            return local;
+        }
+
         // Format html content.
         std::string html_content = R"(<style>
         #pager-container {
@@ -220,7 +270,44 @@ namespace xcpp
         return data;
     }
 
-    xintrospection::xintrospection()
+    nl::json build_declaration_data(const xsymbol& symbol)
+    {
+        return nl::json::object({{"text/plain", summary(symbol)}, {"text/markdown", markdown_summary(symbol)}});
+    }
+
+    nl::json inspect_data(const std::string& code, xsymbol_index* index)
+    {
+        std::smatch name;
+        const bool is_name = index != nullptr
+                             && std::regex_match(code, name, std::regex(R"(\s*((?:::)?\w+(?:::\w+)*)\s*)"));
+        // The names declared by the cells have no documentation page and
+        // may shadow the ones of the tagfiles.
+        if (is_name)
+        {
+            if (const xsymbol* symbol = index->find(name[1]))
+            {
+                return build_declaration_data(*symbol);
+            }
+        }
+        std::string result = inspect(code);
+        if (!result.empty())
+        {
+            return build_inspect_data(result);
+        }
+        // Otherwise the declarations known to the interpreter, such as those
+        // of the headers included by the cells, are shown.
+        if (is_name)
+        {
+            if (const xsymbol* symbol = index->describe(name[1]))
+            {
+                return build_declaration_data(*symbol);
+            }
+        }
+        return nl::json::object();
+    }
+
+    xintrospection::xintrospection(xsymbol_index* index)
+        : m_index(index)
     {
         pattern = spattern;
     }
@@ -230,8 +317,8 @@ namespace xcpp
         std::regex re(spattern + R"((.*))");
         std::smatch to_inspect;
         std::regex_search(code, to_inspect, re);
-        std::string result = inspect(to_inspect[1]);
-        if (result.empty())
+        nl::json data = inspect_data(to_inspect[1], m_index);
+        if (data.empty())
         {
             std::cerr << "No documentation found for " << code << std::endl;
             kernel_res = xeus::create_error_reply("No documentation found");
@@ -239,9 +326,7 @@ namespace xcpp
         else
         {
             auto payload = nl::json::array();
-            payload[0] = nl::json::object(
-                {{"data", build_inspect_data(result)}, {"source", "page"}, {"start", 0}}
-            );
+            payload[0] = nl::json::object({{"data", std::move(data)}, {"source", "page"}, {"start", 0}});
             kernel_res = xeus::create_successful_reply(payload);
         }
     }
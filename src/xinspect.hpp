@@ -41,9 +41,33 @@ namespace xcpp
         bool operator()(pugi::xml_node node) const;
     };
 
+    // Qualified name of a type or of the type of an expression, empty if it
+    // cannot be resolved. Results are cached until clear_type_cache().
+    XEUS_CPP_API
+    std::string find_type_slow(const std::string& expression);
+    // Called when the declarations visible to the interpreter change.
+    XEUS_CPP_API
+    void clear_type_cache();
+
     std::string inspect(const std::string& code);
+    // The local copy of the page of `url` if the documentation directory
+    // has one, empty otherwise.
+    XEUS_CPP_API
+    nl::json local_docs_data(const std::string& url);
     nl::json build_inspect_data(const std::string& inspect_result);
 
+    struct xsymbol;
+    class xsymbol_index;
+
+    XEUS_CPP_API
+    nl::json build_declaration_data(const xsymbol& symbol);
+    // Mime bundle documenting `code`: the declaration of a name declared by
+    // the cells, the page of the tagfiles, or the declaration of a name known
+    // to the interpreter, in that order. Empty if none is found. Only the
+    // tagfiles are searched if `index` is null.
+    XEUS_CPP_API
+    nl::json inspect_data(const std::string& code, xsymbol_index* index);
+
     class XEUS_CPP_API xintrospection : public xpreamble
     {
     public:
@@ -51,11 +75,15 @@ namespace xcpp
         using xpreamble::pattern;
         const std::string spattern = R"(^\?)";
 
-        xintrospection();
+        explicit xintrospection(xsymbol_index* index = nullptr);
 
         void apply(const std::string& code, nl::json& kernel_res) override;
 
         [[nodiscard]] std::unique_ptr<xpreamble> clone() const override;
+
+    private:
+
+        xsymbol_index* m_index;
     };
 }
 
@@ -15,46 +15,81 @@
 #include "xeus-cpp/xbuffer.hpp"
 #include "xeus-cpp/xeus_cpp_config.hpp"
 #include "xeus-cpp/xinterpreter.hpp"
+#include "xeus-cpp/xiopub.hpp"
 #include "xeus-cpp/xmagics.hpp"
+#include "xeus-cpp/xutils.hpp"
 
+#include "xcache.hpp"
+#include "xcompiler.hpp"
+#include "xcompletion.hpp"
 #include "xinput.hpp"
 #include "xinput_validator.hpp"
 #include "xinspect.hpp"
+#include "xinterrupt.hpp"
+#include "xlive_output.hpp"
+#include "xmagics/execution.hpp"
 #include "xmagics/os.hpp"
+#include "xmagics/stats.hpp"
+#include "xmagics/who.hpp"
 #include <algorithm>
+#include <chrono>
+#include <cstdint>
 #include <cstdlib>
+#include <filesystem>
 #include <iostream>
+#include <iterator>
+#include <optional>
+#include <utility>
 #ifndef __EMSCRIPTEN__
+#include "xmagics/executable.hpp"
+#include "xmagics/opt.hpp"
 #include "xmagics/xassist.hpp"
 #endif
+#include "xoptimizer.hpp"
+#include "xoutput_limiter.hpp"
 #include "xparser.hpp"
+#include "xstats.hpp"
+#include "xsymbol_index.hpp"
 #include "xsystem.hpp"
 
 using Args = std::vector<const char*>;
 
-void* createInterpreter(const Args &ExtraArgs = {}) {
+void* createInterpreter(const Args &ExtraArgs, std::vector<std::string>& InterpArgs) {
   Args ClangArgs = {/*"-xc++"*/"-v"};
-  std::string resource_dir;
-  if (std::find_if(ExtraArgs.begin(), ExtraArgs.end(), [](const std::string& s) {
-    return s == "-resource-dir";}) == ExtraArgs.end()) {
-      resource_dir = Cpp::DetectResourceDir();
-      if (!resource_dir.empty())
+  bool has_resource_dir = std::find_if(ExtraArgs.begin(), ExtraArgs.end(), [](const std::string& s) {
+    return s == "-resource-dir";}) != ExtraArgs.end();
+  // Spawning the host compiler to discover its paths is slow, the result is
+  // cached across kernel launches.
+  xcpp::xcompiler_paths CompilerPaths = xcpp::detect_compiler_paths(
+      std::vector<std::string>(ExtraArgs.begin(), ExtraArgs.end()), !has_resource_dir);
+  if (!has_resource_dir) {
+      if (!CompilerPaths.resource_dir.empty())
       {
           ClangArgs.push_back("-resource-dir");
-          ClangArgs.push_back(resource_dir.c_str());
+          ClangArgs.push_back(CompilerPaths.resource_dir.c_str());
       }
       else
       {
           std::cerr << "Failed to detect the resource-dir\n";
       }
   }
-  std::vector<std::string> CxxSystemIncludes;
-  Cpp::DetectSystemCompilerIncludePaths(CxxSystemIncludes);
-  for (const std::string& CxxInclude : CxxSystemIncludes) {
+  for (const std::string& CxxInclude : CompilerPaths.system_includes) {
     ClangArgs.push_back("-isystem");
     ClangArgs.push_back(CxxInclude.c_str());
   }
-  ClangArgs.insert(ClangArgs.end(), ExtraArgs.begin(), ExtraArgs.end());
+  for (auto it = ExtraArgs.begin(); it != ExtraArgs.end(); ++it) {
+    // The kernelspecs may point to a precompiled prelude that was not
+    // generated, start without it rather than failing to create the
+    // interpreter.
+    if (std::string(*it) == "-include-pch" && std::next(it) != ExtraArgs.end() &&
+        !std::filesystem::exists(*std::next(it))) {
+      std::cerr << "Precompiled header " << *std::next(it) << " not found, ignoring it\n";
+      ++it;
+      continue;
+    }
+    ClangArgs.push_back(*it);
+  }
+  InterpArgs.assign(ClangArgs.begin(), ClangArgs.end());
   // FIXME: We should process the kernel input options and conditionally pass
   // the gpu args here.
   Cpp::TInterp_t res = Cpp::CreateInterpreter(ClangArgs /*, {"-cuda"}*/);
@@ -84,16 +119,23 @@ using namespace std::placeholders;
 
 namespace xcpp
 {
+    // The diagnostics are collected for the error reply, up to half of the
+    // output budget, the output of the cell is forwarded while it runs.
     struct StreamRedirectRAII {
-      std::string &err;
-      StreamRedirectRAII(std::string &e) : err(e) {
-        Cpp::BeginStdStreamCapture(Cpp::kStdErr);
-        Cpp::BeginStdStreamCapture(Cpp::kStdOut);
+      xoutput_limiter errors;
+      std::optional<xlive_output> err_out;
+      std::optional<xlive_output> out;
+      StreamRedirectRAII(std::string &e, std::size_t budget, xlive_output::callback_type cb)
+          : errors("diagnostics", [&e](const std::string& chunk) { e += chunk; }) {
+        errors.set_budget(budget / 2);
+        errors.start();
+        err_out.emplace([this](const std::string& chunk) { errors.write(chunk); }, stderr);
+        out.emplace(std::move(cb), stdout);
       }
       ~StreamRedirectRAII() {
-        std::string out = Cpp::EndStdStreamCapture();
-        err = Cpp::EndStdStreamCapture();
-        std::cout << out;
+        out.reset();
+        err_out.reset();
+        errors.finish();
       }
     };
 
@@ -236,6 +278,85 @@ namespace xcpp
         return "unknown";
     }
 
+    // Cells whose compilation depends on something else than the preceding
+    // cells and the interpreter flags cannot be replayed from the cell cache.
+    static bool is_cacheable(const std::string& code)
+    {
+        static const std::regex re_external(
+            R"((^\s*#\s*(include|include_next|import|embed)\b)|__has_include|__DATE__|__TIME__|__TIMESTAMP__)",
+            std::regex::multiline
+        );
+        return !std::regex_search(code, re_external);
+    }
+
+    static std::unique_ptr<xcell_cache> make_cell_cache()
+    {
+        // Size cap in megabytes, 0 disables the cache. Opt-in, it only
+        // saves the compilation of the cells that fail.
+        std::uintmax_t max_size = 0;
+        if (const char* size_env = std::getenv("XCPP_CELL_CACHE_SIZE"))
+        {
+            max_size = std::strtoull(size_env, nullptr, 10);
+        }
+        std::string directory = retrieve_cache_dir();
+        if (!directory.empty())
+        {
+            directory += "/cells";
+        }
+        return std::make_unique<xcell_cache>(directory, max_size * 1024 * 1024);
+    }
+
+    static void configure_output_coalescing(xoutput_buffer& buffer)
+    {
+        // Interval in milliseconds and size threshold in bytes. The output
+        // is published on every flush unless an interval is given.
+        const char* interval_env = std::getenv("XCPP_OUTPUT_INTERVAL");
+        if (interval_env == nullptr)
+        {
+            return;
+        }
+        std::size_t max_size = 64 * 1024;
+        if (const char* size_env = std::getenv("XCPP_OUTPUT_MAX_SIZE"))
+        {
+            max_size = std::strtoull(size_env, nullptr, 10);
+        }
+        buffer.set_coalescing(std::chrono::milliseconds(std::strtoull(interval_env, nullptr, 10)), max_size);
+    }
+
+    static std::chrono::milliseconds completion_timeout()
+    {
+        long long timeout = 500;
+        if (const char* timeout_env = std::getenv("XCPP_COMPLETION_TIMEOUT"))
+        {
+            timeout = std::strtoll(timeout_env, nullptr, 10);
+        }
+        return std::chrono::milliseconds(std::max(timeout, 0LL));
+    }
+
+    static std::size_t output_budget()
+    {
+        // Budget in megabytes of the output of a cell on each stream, 0
+        // disables it.
+        std::size_t budget = 8;
+        if (const char* budget_env = std::getenv("XCPP_OUTPUT_BUDGET"))
+        {
+            budget = std::strtoull(budget_env, nullptr, 10);
+        }
+        return budget * 1024 * 1024;
+    }
+
+    static std::uintmax_t output_spill_limit()
+    {
+        // Size cap in megabytes of the files holding the output past the
+        // budget, 0 disables it.
+        std::uintmax_t limit = 1024;
+        if (const char* limit_env = std::getenv("XCPP_OUTPUT_SPILL_SIZE"))
+        {
+            limit = std::strtoull(limit_env, nullptr, 10);
+        }
+        return limit * 1024 * 1024;
+    }
+
     class SilentStreamRedirectRAII
     {
     public:
@@ -283,12 +404,48 @@ namespace xcpp
         , m_cerr_buffer(std::bind(&interpreter::publish_stderr, this, _1))
     {
         //NOLINTNEXTLINE (cppcoreguidelines-pro-bounds-pointer-arithmetic)
-        createInterpreter(Args(argv ? argv + 1 : argv, argv + argc));
+        createInterpreter(Args(argv ? argv + 1 : argv, argv + argc), m_interpreter_args);
+        std::string flags = std::string(XEUS_CPP_VERSION) + '\0' + Cpp::GetVersion();
+        for (const std::string& arg : m_interpreter_args)
+        {
+            flags.append(1, '\0').append(arg);
+        }
+        m_flags_digest = xcell_cache::digest(flags);
+        m_replayable = true;
+        m_cell_cache = make_cell_cache();
+        m_stats = std::make_unique<xstats>();
+        m_symbol_index = std::make_unique<xsymbol_index>();
+        m_completion_cache = std::make_unique<xcompletion_cache>();
+        m_completion_timeout = completion_timeout();
+        m_completion_warm = false;
+        m_optimizer = std::make_unique<xoptimizer>(m_interpreter_args, m_declarations);
         m_version = get_stdopt();
         m_language = get_language();
+        configure_output_coalescing(m_cout_buffer);
+        configure_output_coalescing(m_cerr_buffer);
+        m_stdout_limiter = std::make_unique<xoutput_limiter>(
+            "stdout",
+            [this](const std::string& s)
+            {
+                publish_stream("stdout", s);
+            }
+        );
+        m_stderr_limiter = std::make_unique<xoutput_limiter>(
+            "stderr",
+            [this](const std::string& s)
+            {
+                publish_stream("stderr", s);
+            }
+        );
+        m_stdout_limiter->set_budget(output_budget());
+        m_stderr_limiter->set_budget(output_budget());
+        m_stdout_limiter->set_spill_limit(output_spill_limit());
+        m_stderr_limiter->set_spill_limit(output_spill_limit());
         redirect_output();
         init_preamble();
         init_magic();
+        // What the kernel itself declared is not listed.
+        m_symbol_index->snapshot();
     }
 
     interpreter::~interpreter()
@@ -298,32 +455,50 @@ namespace xcpp
 
     void interpreter::execute_request_impl(
         send_reply_callback cb,
-        int /*execution_count*/,
+        int execution_count,
         const std::string& code,
         xeus::execute_request_config config,
         nl::json /*user_expressions*/
     )
     {
         nl::json kernel_res;
-
+        phase_timer total_timer(*m_stats, "execute_request", "total");
 
         auto input_guard = input_redirection(config.allow_stdin);
+        // Even a failing cell may have declared names.
+        finish_completion();
+        m_completion_cache->invalidate();
+        clear_type_cache();
+        m_optimizer->start_cell(execution_count);
+        start_output();
 
         // Check for magics
+        phase_timer preamble_timer(*m_stats, "execute_request", "preamble");
         for (auto& pre : preamble_manager.preamble)
         {
             if (pre.second.is_match(code))
             {
-                pre.second.apply(code, kernel_res);
+                preamble_timer.stop();
+                {
+                    phase_timer magic_timer(*m_stats, "execute_request", "magic");
+                    pre.second.apply(code, kernel_res);
+                }
+                // Magics such as %%opt and %%timeit declare code through
+                // Cpp::Process, the cells following them are keyed after them.
+                m_cell_key = xcell_cache::make_key(m_cell_key, m_flags_digest, code);
+                phase_timer publish_timer(*m_stats, "execute_request", "publish");
+                flush_output();
                 cb(kernel_res);
                 return;
             }
         }
+        preamble_timer.stop();
 
         auto errorlevel = 0;
         std::string ename;
         std::string evalue;
         bool compilation_result = false;
+        bool interrupted = false;
 
         // If silent is set to true, temporarily dismiss all std::cerr and
         // std::cout outputs resulting from `process_code`.
@@ -331,25 +506,110 @@ namespace xcpp
 
         std::string err;
 
+        // A cell that already failed to compile after the exact same sequence
+        // of cells is answered from the cache instead of being recompiled.
+        const std::string cell_key = xcell_cache::make_key(m_cell_key, m_flags_digest, code);
+        const bool cacheable = m_replayable && !m_optimizer->active() && is_cacheable(code);
+        const bool cached = cacheable && m_cell_cache->lookup(cell_key, code, err);
+
+        // Once %opt set code generation flags, function definitions are
+        // compiled ahead of time and the interpreter only sees their
+        // prototypes.
+        std::string jit_code = code;
+        std::string pipeline = m_optimizer->jit_pipeline();
+        const bool offloaded = cached || !m_optimizer->active()
+                               || m_optimizer->offload(code, m_optimizer->flags(), jit_code, pipeline, err);
+
         // Attempt normal evaluation
-        try
+        if (cached || !offloaded)
         {
-            StreamRedirectRAII R(err);
-            compilation_result = Cpp::Process(code.c_str());
+            compilation_result = true;
         }
-        catch (std::exception& e)
+        else
         {
-            errorlevel = 1;
-            ename = "Standard Exception: ";
-            evalue = e.what();
+            // The capture of the diagnostics is the time spent in the
+            // redirection around Cpp::Process.
+            const auto capture_start = xstats::clock::now();
+            xstats::clock::duration process_time{};
+            try
+            {
+                StreamRedirectRAII R(
+                    err,
+                    m_stdout_limiter->budget(),
+                    [this, silent = config.silent](const std::string& chunk)
+                    {
+                        if (!silent)
+                        {
+                            publish_stdout(chunk);
+                        }
+                    }
+                );
+                phase_timer process_timer(*m_stats, "execute_request", "process");
+                // An interrupted cell keeps what it declared, only its
+                // execution is abandoned. The jump back to the checkpoint
+                // also skips the frames of Cpp::Process and clang below the
+                // user code, which never return.
+                interrupted = !run_interruptible(
+                    [&jit_code, &compilation_result]()
+                    {
+                        compilation_result = Cpp::Process(jit_code.c_str());
+                    },
+                    [this]()
+                    {
+                        publish_stderr(
+                            "The cell cannot be interrupted while it runs library code, it will stop once it "
+                            "returns to its own code. Restart the kernel to stop it now.\n"
+                        );
+                    }
+                );
+                process_time = process_timer.stop();
+            }
+            catch (std::exception& e)
+            {
+                errorlevel = 1;
+                ename = "Standard Exception: ";
+                evalue = e.what();
+            }
+            catch (...)
+            {
+                errorlevel = 1;
+                ename = "Error: ";
+            }
+            m_stats->record("execute_request", "capture", xstats::clock::now() - capture_start - process_time);
         }
-        catch (...)
+
+        if (compilation_result && !interrupted)
         {
-            errorlevel = 1;
-            ename = "Error: ";
+            if (cacheable && !cached)
+            {
+                m_cell_cache->store(cell_key, code, err);
+            }
+        }
+        else
+        {
+            // Failed compilations are rolled back by the interpreter, only
+            // the other cells contribute to the state seen by the next one.
+            m_cell_key = cell_key;
+            // The included files may have changed when the same cells are
+            // run again, so no later failure can be replayed.
+            m_replayable = cacheable;
+            for (std::string& declaration : split_declarations(code))
+            {
+                m_declarations.push_back(std::move(declaration));
+            }
+            m_optimizer->record(pipeline);
+            phase_timer index_timer(*m_stats, "execute_request", "index");
+            m_symbol_index->update(code, execution_count);
         }
 
-        if (compilation_result)
+        if (interrupted)
+        {
+            errorlevel = 1;
+            ename = "Interrupted: ";
+            evalue = "Execution was interrupted";
+            std::cerr << err;
+        }
+        else if (compilation_result)
         {
             errorlevel = 1;
             ename = "Error: ";
@@ -360,7 +620,9 @@ namespace xcpp
         // Flush streams
         std::cout << std::flush;
         std::cerr << std::flush;
+        flush_output();
 
+        phase_timer publish_timer(*m_stats, "execute_request", "publish");
         // Depending of error level, publish execution result or execution
         // error, and compose execute_reply message.
         if (errorlevel)
@@ -376,7 +638,12 @@ namespace xcpp
             std::vector<std::string> traceback({ename  + evalue});
             if (!config.silent)
             {
-                publish_execution_error(ename, evalue, traceback);
+                publish_serialized(
+                    [&]()
+                    {
+                        publish_execution_error(ename, evalue, traceback);
+                    }
+                );
             }
 
             // Compose execute_reply message.
@@ -401,6 +668,7 @@ namespace xcpp
 
     nl::json interpreter::complete_request_impl(const std::string& code, int cursor_pos)
     {
+        phase_timer total_timer(*m_stats, "complete_request", "total");
         std::vector<std::string> results;
 
         // split the input to have only the word in the back of the cursor
@@ -408,8 +676,54 @@ namespace xcpp
         std::size_t _cursor_pos = cursor_pos;
         auto text = split_line(code, delims, _cursor_pos);
         std::string to_complete = text.back().c_str();
+        // Code before the token, the candidates of the token only depend on it.
+        const std::string context = code.substr(0, _cursor_pos - std::min(_cursor_pos, to_complete.size()));
 
-        Cpp::CodeComplete(results, code.c_str(), 1, _cursor_pos + 1);
+        const auto deadline = std::chrono::steady_clock::now() + m_completion_timeout;
+
+        phase_timer cache_timer(*m_stats, "complete_request", "cache");
+        bool found = m_completion_cache->lookup(context, to_complete, results);
+        cache_timer.stop();
+        if (!found)
+        {
+            phase_timer complete_timer(*m_stats, "complete_request", "code_complete");
+            // A completion that exceeded its budget still uses the interpreter.
+            // Its candidates may cover this request, otherwise they are only
+            // cached: the request it answered was already replied to.
+            if (m_completion_task && wait_completion(deadline))
+            {
+                found = m_completion_cache->lookup(context, to_complete, results);
+            }
+            if (!found && !m_completion_task)
+            {
+                m_completion_task = std::make_unique<xcompletion_task>(
+                    context,
+                    to_complete,
+                    [code, pos = _cursor_pos]
+                    {
+                        std::vector<std::string> res;
+                        Cpp::CodeComplete(res, code.c_str(), 1, pos + 1);
+                        return res;
+                    }
+                );
+                found = wait_completion(deadline) && m_completion_cache->lookup(context, to_complete, results);
+            }
+            // Past the budget, the reply only has the names declared by the
+            // cells, unless the token is a member. Asking again once the
+            // completion is done gets all the candidates from the cache.
+            if (!found)
+            {
+                results.clear();
+                const char before = context.empty() ? ' ' : context.back();
+                if (before != '.' && before != ':' && before != '>')
+                {
+                    for (const xsymbol* symbol : m_symbol_index->complete(to_complete))
+                    {
+                        results.push_back(symbol->name);
+                    }
+                }
+            }
+        }
 
         return xeus::create_complete_reply(results /*matches*/,
             cursor_pos - to_complete.length() /*cursor_start*/,
@@ -419,18 +733,22 @@ namespace xcpp
 
     nl::json interpreter::inspect_request_impl(const std::string& code, int cursor_pos, int /*detail_level*/)
     {
+        phase_timer total_timer(*m_stats, "inspect_request", "total");
+        finish_completion();
         std::regex re(R"((\w*(?:\:{2}|\<.*\>|\(.*\)|\[.*\])?)(\.?)*$)");
 
         std::smatch inspect_request;
         std::string sub_code = code.substr(0, cursor_pos);
         if (std::regex_search(sub_code, inspect_request, re))
         {
-            std::string result = inspect(inspect_request[0]);
-            if (result.empty())
+            phase_timer lookup_timer(*m_stats, "inspect_request", "lookup");
+            nl::json data = inspect_data(inspect_request[0], m_symbol_index.get());
+            lookup_timer.stop();
+            if (data.empty())
             {
                 return xeus::create_inspect_reply(false);
             }
-            return xeus::create_inspect_reply(true, build_inspect_data(result));
+            return xeus::create_inspect_reply(true, std::move(data));
         }
         return xeus::create_inspect_reply(false);
     }
@@ -484,9 +802,69 @@ namespace xcpp
 
     nl::json interpreter::interrupt_request_impl()
     {
+        request_interrupt();
         return xeus::create_interrupt_reply();
     }
 
+    bool interpreter::wait_completion(std::chrono::steady_clock::time_point deadline)
+    {
+        // The first completion of the kernel parses the headers included so
+        // far and would almost always exceed the budget, it runs to the end.
+        if (m_completion_timeout.count() != 0 && m_completion_warm)
+        {
+            const auto now = std::chrono::steady_clock::now();
+            const auto remaining = std::chrono::duration_cast<std::chrono::milliseconds>(
+                deadline > now ? deadline - now : std::chrono::steady_clock::duration::zero()
+            );
+            if (!m_completion_task->wait_for(remaining))
+            {
+                return false;
+            }
+        }
+        finish_completion();
+        return true;
+    }
+
+    void interpreter::finish_completion()
+    {
+        if (m_completion_task)
+        {
+            std::vector<std::string> results = m_completion_task->get();
+            m_completion_cache->store(m_completion_task->context(), m_completion_task->token(), results);
+            m_completion_task.reset();
+            m_completion_warm = true;
+        }
+    }
+
+    void interpreter::start_output()
+    {
+        // The output printed by other threads since the previous cell is
+        // published at the start of this one.
+        begin_cell_output(
+            [this]()
+            {
+                m_stdout_limiter->start();
+                m_stderr_limiter->start();
+            }
+        );
+    }
+
+    void interpreter::flush_output()
+    {
+        // The output held back by the coalescing, and the end of the output
+        // past the budget, precede the reply.
+        m_cout_buffer.flush_pending();
+        m_cerr_buffer.flush_pending();
+        publish_serialized(
+            [this]()
+            {
+                m_stdout_limiter->finish();
+                m_stderr_limiter->finish();
+            }
+        );
+        end_cell_output();
+    }
+
     void interpreter::redirect_output()
     {
         p_cout_strbuf = std::cout.rdbuf();
@@ -504,18 +882,31 @@ namespace xcpp
 
     void interpreter::publish_stdout(const std::string& s)
     {
-        publish_stream("stdout", s);
+        publish_serialized(
+            [this, s]()
+            {
+                m_stdout_limiter->write(s);
+            }
+        );
     }
 
     void interpreter::publish_stderr(const std::string& s)
     {
-        publish_stream("stderr", s);
+        publish_serialized(
+            [this, s]()
+            {
+                m_stderr_limiter->write(s);
+            }
+        );
     }
 
     void interpreter::init_preamble()
     {
         //NOLINTBEGIN(cppcoreguidelines-owning-memory)
-        preamble_manager.register_preamble("introspection", std::make_unique<xintrospection>());
+        preamble_manager.register_preamble(
+            "introspection",
+            std::make_unique<xintrospection>(m_symbol_index.get())
+        );
         preamble_manager.register_preamble("magics", std::make_unique<xmagics_manager>());
         preamble_manager.register_preamble("shell", std::make_unique<xsystem>());
         //NOLINTEND(cppcoreguidelines-owning-memory)
@@ -523,13 +914,23 @@ namespace xcpp
 
     void interpreter::init_magic()
     {
-        // preamble_manager["magics"].get_cast<xmagics_manager>().register_magic("executable",
-        // executable(m_interpreter));
-        // preamble_manager["magics"].get_cast<xmagics_manager>().register_magic("timeit",
-        // timeit(&m_interpreter));
         // preamble_manager["magics"].get_cast<xmagics_manager>().register_magic("python", pythonexec());
         preamble_manager["magics"].get_cast<xmagics_manager>().register_magic("file", writefile());
+        preamble_manager["magics"].get_cast<xmagics_manager>().register_magic("timeit", timeit());
+        preamble_manager["magics"].get_cast<xmagics_manager>().register_magic(
+            "kernel_stats",
+            kernel_stats(*m_stats, *m_cell_cache)
+        );
+        preamble_manager["magics"].get_cast<xmagics_manager>().register_magic("who", who(*m_symbol_index));
 #ifndef __EMSCRIPTEN__
+        preamble_manager["magics"].get_cast<xmagics_manager>().register_magic(
+            "executable",
+            executable(m_interpreter_args, m_declarations)
+        );
+        preamble_manager["magics"].get_cast<xmagics_manager>().register_magic(
+            "opt",
+            opt(*m_optimizer, m_declarations)
+        );
         preamble_manager["magics"].get_cast<xmagics_manager>().register_magic("xassist", xassist());
 #endif
     }
@@ -0,0 +1,319 @@
+/************************************************************************************
+ * Copyright (c) 2025, xeus-cpp contributors                                        *
+ *                                                                                  *
+ * Distributed under the terms of the BSD 3-Clause License.                         *
+ *                                                                                  *
+ * The full license is in the file LICENSE, distributed with this software.         *
+ ************************************************************************************/
+
+#include <functional>
+
+#include "xinterrupt.hpp"
+
+#if !defined(_WIN32) && !defined(__EMSCRIPTEN__)
+
+#include <atomic>
+#include <chrono>
+#include <csetjmp>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+
+#include <pthread.h>
+#include <signal.h>
+#include <unistd.h>
+
+#if defined(__linux__)
+#include <link.h>
+#include <ucontext.h>
+#elif defined(__APPLE__)
+#include <sys/ucontext.h>
+#endif
+
+#include <CppInterOp/CppInterOp.h>
+
+#include "xeus/xinterpreter.hpp"
+
+namespace xcpp
+{
+    namespace
+    {
+        // SIGINT is only received by the watcher thread, which then signals
+        // the executing thread with `kick_signal` until it lands in code it
+        // is safe to jump out of. Past the grace period, the cell is reported
+        // as blocked and kicked less often.
+        constexpr int kick_signal = SIGUSR2;
+        constexpr auto retry_interval = std::chrono::milliseconds(10);
+        constexpr auto blocked_retry_interval = std::chrono::milliseconds(100);
+        constexpr auto grace_period = std::chrono::seconds(1);
+
+        enum class code_kind
+        {
+            // Code compiled by the interpreter or loaded after startup.
+            user,
+            // Libraries loaded at startup (libc, libstdc++, ...). Never
+            // interrupted either, jumping out of malloc or stdio would leave
+            // their locks held and deadlock the kernel.
+            runtime,
+            // The kernel, xeus and the compiler. Never interrupted.
+            kernel
+        };
+
+        struct code_range
+        {
+            std::uintptr_t begin;
+            std::uintptr_t end;
+            bool kernel;
+        };
+
+        // Filled once before the handler is installed, only read from it.
+        constexpr std::size_t max_ranges = 1024;
+        code_range ranges[max_ranges];
+        std::size_t range_count = 0;
+
+        bool enabled = false;
+        sigjmp_buf checkpoint;
+        pthread_t executing_thread;
+        std::atomic<bool> executing(false);
+        std::atomic<bool> pending(false);
+        // Called by the watcher thread when the executing code cannot be
+        // interrupted. Set and cleared by run_interruptible.
+        std::mutex blocked_mutex;
+        const std::function<void()>* on_blocked = nullptr;
+        std::atomic<unsigned long> execution_id(0);
+        std::atomic<int> guard_depth(0);
+
+#if defined(__linux__)
+        int collect_object(dl_phdr_info* info, std::size_t, void* data)
+        {
+            const auto* probes = static_cast<const std::uintptr_t*>(data);
+            const std::size_t first = range_count;
+            bool kernel = info->dlpi_name == nullptr || info->dlpi_name[0] == '\0';
+            for (int i = 0; i < info->dlpi_phnum && range_count < max_ranges; ++i)
+            {
+                const auto& header = info->dlpi_phdr[i];
+                if (header.p_type != PT_LOAD || (header.p_flags & PF_X) == 0)
+                {
+                    continue;
+                }
+                std::uintptr_t begin = info->dlpi_addr + header.p_vaddr;
+                std::uintptr_t end = begin + header.p_memsz;
+                for (std::size_t p = 0; probes[p] != 0; ++p)
+                {
+                    kernel = kernel || (probes[p] >= begin && probes[p] < end);
+                }
+                ranges[range_count++] = {begin, end, false};
+            }
+            for (std::size_t i = first; i < range_count; ++i)
+            {
+                ranges[i].kernel = kernel;
+            }
+            return 0;
+        }
+#endif
+
+        void collect_code_ranges()
+        {
+#if defined(__linux__)
+            // One function of each library that must never be left midway.
+            std::uintptr_t probes[] = {
+                reinterpret_cast<std::uintptr_t>(&Cpp::Process),
+                reinterpret_cast<std::uintptr_t>(&xeus::register_interpreter),
+                reinterpret_cast<std::uintptr_t>(&run_interruptible),
+                0
+            };
+            dl_iterate_phdr(collect_object, probes);
+#endif
+        }
+
+        std::uintptr_t program_counter(void* context)
+        {
+            [[maybe_unused]] auto* uc = static_cast<ucontext_t*>(context);
+#if defined(__linux__) && defined(__x86_64__)
+            return static_cast<std::uintptr_t>(uc->uc_mcontext.gregs[REG_RIP]);
+#elif defined(__linux__) && defined(__aarch64__)
+            return static_cast<std::uintptr_t>(uc->uc_mcontext.pc);
+#elif defined(__APPLE__) && defined(__x86_64__)
+            return static_cast<std::uintptr_t>(uc->uc_mcontext->__ss.__rip);
+#elif defined(__APPLE__) && defined(__arm64__)
+            return static_cast<std::uintptr_t>(uc->uc_mcontext->__ss.__pc);
+#else
+            return 0;
+#endif
+        }
+
+        code_kind classify(std::uintptr_t pc)
+        {
+            if (pc == 0 || range_count == 0)
+            {
+                return code_kind::runtime;
+            }
+            for (std::size_t i = 0; i < range_count; ++i)
+            {
+                if (pc >= ranges[i].begin && pc < ranges[i].end)
+                {
+                    return ranges[i].kernel ? code_kind::kernel : code_kind::runtime;
+                }
+            }
+            return code_kind::user;
+        }
+
+        void on_kick(int, siginfo_t*, void* context)
+        {
+            if (!executing.load() || !pending.load() || guard_depth.load() > 0
+                || !pthread_equal(pthread_self(), executing_thread))
+            {
+                return;
+            }
+            if (classify(program_counter(context)) != code_kind::user)
+            {
+                return;
+            }
+            executing.store(false);
+            pending.store(false);
+            siglongjmp(checkpoint, 1);
+        }
+
+        void watch_interrupts(sigset_t set)
+        {
+            while (true)
+            {
+                int sig = 0;
+                if (sigwait(&set, &sig) != 0 || !executing.load())
+                {
+                    // Like IPython, an interrupt while idle is ignored.
+                    continue;
+                }
+
+                const unsigned long id = execution_id.load();
+                const auto start = std::chrono::steady_clock::now();
+                bool blocked = false;
+                pending.store(true);
+                while (pending.load() && executing.load() && execution_id.load() == id)
+                {
+                    if (!blocked && std::chrono::steady_clock::now() - start > grace_period)
+                    {
+                        blocked = true;
+                        std::lock_guard<std::mutex> lock(blocked_mutex);
+                        if (on_blocked != nullptr && executing.load() && execution_id.load() == id)
+                        {
+                            (*on_blocked)();
+                        }
+                    }
+                    pthread_kill(executing_thread, kick_signal);
+                    std::this_thread::sleep_for(blocked ? blocked_retry_interval : retry_interval);
+                }
+            }
+        }
+    }
+
+    void init_interrupt_handling()
+    {
+        if (enabled)
+        {
+            return;
+        }
+        collect_code_ranges();
+
+        struct sigaction action = {};
+        action.sa_sigaction = on_kick;
+        action.sa_flags = SA_SIGINFO | SA_RESTART;
+        sigemptyset(&action.sa_mask);
+        sigaction(kick_signal, &action, nullptr);
+
+        sigset_t set;
+        sigemptyset(&set);
+        sigaddset(&set, SIGINT);
+        pthread_sigmask(SIG_BLOCK, &set, nullptr);
+        std::thread(watch_interrupts, set).detach();
+        enabled = true;
+    }
+
+    void request_interrupt()
+    {
+        if (enabled)
+        {
+            kill(getpid(), SIGINT);
+        }
+    }
+
+    bool run_interruptible(const std::function<void()>& fn, const std::function<void()>& blocked)
+    {
+        if (!enabled)
+        {
+            fn();
+            return true;
+        }
+
+        executing_thread = pthread_self();
+        execution_id.fetch_add(1);
+        pending.store(false);
+        {
+            std::lock_guard<std::mutex> lock(blocked_mutex);
+            on_blocked = blocked ? &blocked : nullptr;
+        }
+        auto finish = []()
+        {
+            executing.store(false);
+            std::lock_guard<std::mutex> lock(blocked_mutex);
+            on_blocked = nullptr;
+        };
+        if (sigsetjmp(checkpoint, 1) != 0)
+        {
+            finish();
+            return false;
+        }
+        executing.store(true);
+        try
+        {
+            fn();
+        }
+        catch (...)
+        {
+            finish();
+            throw;
+        }
+        finish();
+        return true;
+    }
+
+    interrupt_guard::interrupt_guard()
+    {
+        guard_depth.fetch_add(1);
+    }
+
+    interrupt_guard::~interrupt_guard()
+    {
+        guard_depth.fetch_sub(1);
+    }
+}
+
+#else
+
+namespace xcpp
+{
+    void init_interrupt_handling()
+    {
+    }
+
+    void request_interrupt()
+    {
+    }
+
+    bool run_interruptible(const std::function<void()>& fn, const std::function<void()>&)
+    {
+        fn();
+        return true;
+    }
+
+    interrupt_guard::interrupt_guard()
+    {
+    }
+
+    interrupt_guard::~interrupt_guard()
+    {
+    }
+}
+
+#endif
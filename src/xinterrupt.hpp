@@ -0,0 +1,54 @@
+/************************************************************************************
+ * Copyright (c) 2025, xeus-cpp contributors                                        *
+ *                                                                                  *
+ * Distributed under the terms of the BSD 3-Clause License.                         *
+ *                                                                                  *
+ * The full license is in the file LICENSE, distributed with this software.         *
+ ************************************************************************************/
+
+#ifndef XEUS_CPP_INTERRUPT_HPP
+#define XEUS_CPP_INTERRUPT_HPP
+
+#include <functional>
+
+#include "xeus-cpp/xeus_cpp_config.hpp"
+
+namespace xcpp
+{
+    // Routes SIGINT to a dedicated thread instead of terminating the kernel.
+    // Must be called before the kernel starts its threads, which inherit the
+    // signal mask of the caller.
+    XEUS_CPP_API
+    void init_interrupt_handling();
+
+    // Interrupts the code run by `run_interruptible`, if any.
+    XEUS_CPP_API
+    void request_interrupt();
+
+    // Runs `fn` on the calling thread and returns false if it was interrupted.
+    // Only code compiled by the interpreter is interrupted: an interruption
+    // received while `fn` runs a library or the kernel waits for it to return
+    // to the compiled code, and `blocked` is called from another thread if it
+    // does not within a second. An interrupted call is abandoned: the frames
+    // below it are left without running destructors, so the objects they
+    // hold are not destroyed and their locks are not released.
+    XEUS_CPP_API
+    bool run_interruptible(const std::function<void()>& fn, const std::function<void()>& blocked = {});
+
+    // Defers interruptions while alive, for code run during an interruptible
+    // call that holds locks, such as publishing messages.
+    class XEUS_CPP_API interrupt_guard
+    {
+    public:
+
+        interrupt_guard();
+        ~interrupt_guard();
+
+        interrupt_guard(const interrupt_guard&) = delete;
+        interrupt_guard& operator=(const interrupt_guard&) = delete;
+        interrupt_guard(interrupt_guard&&) = delete;
+        interrupt_guard& operator=(interrupt_guard&&) = delete;
+    };
+}
+
+#endif
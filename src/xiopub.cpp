@@ -0,0 +1,124 @@
+/************************************************************************************
+ * Copyright (c) 2025, xeus-cpp contributors                                        *
+ *                                                                                  *
+ * Distributed under the terms of the BSD 3-Clause License.                         *
+ *                                                                                  *
+ * The full license is in the file LICENSE, distributed with this software.         *
+ ************************************************************************************/
+
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "xeus-cpp/xiopub.hpp"
+
+#include "xinterrupt.hpp"
+
+namespace xcpp
+{
+    namespace
+    {
+        // Messages held between two cells, beyond which they are dropped so
+        // that a thread printing while the kernel is idle cannot exhaust the
+        // memory.
+        constexpr std::size_t max_held_messages = 4096;
+
+        struct iopub_state
+        {
+            // Recursive so that output printed while publishing, by a
+            // callback of a display for instance, does not deadlock.
+            std::recursive_mutex mutex;
+            std::thread::id shell_thread;
+            bool in_cell = false;
+            std::vector<std::function<void()>> held;
+            // Not taken with `mutex`, the callbacks wait for threads that
+            // publish.
+            std::mutex callbacks_mutex;
+            std::size_t next_callback = 0;
+            std::vector<std::pair<std::size_t, std::function<void()>>> cell_end_callbacks;
+        };
+
+        iopub_state& state()
+        {
+            static iopub_state instance;
+            return instance;
+        }
+    }
+
+    void publish_serialized(std::function<void()> publish)
+    {
+        interrupt_guard guard;
+        iopub_state& iopub = state();
+        std::lock_guard<std::recursive_mutex> lock(iopub.mutex);
+        if (!iopub.in_cell && std::this_thread::get_id() != iopub.shell_thread)
+        {
+            if (iopub.held.size() < max_held_messages)
+            {
+                iopub.held.push_back(std::move(publish));
+            }
+            return;
+        }
+        publish();
+    }
+
+    void begin_cell_output(const std::function<void()>& start)
+    {
+        interrupt_guard guard;
+        iopub_state& iopub = state();
+        std::lock_guard<std::recursive_mutex> lock(iopub.mutex);
+        iopub.shell_thread = std::this_thread::get_id();
+        iopub.in_cell = true;
+        start();
+        std::vector<std::function<void()>> held;
+        held.swap(iopub.held);
+        for (std::function<void()>& publish : held)
+        {
+            publish();
+        }
+    }
+
+    void end_cell_output()
+    {
+        iopub_state& iopub = state();
+        {
+            std::lock_guard<std::mutex> callbacks_lock(iopub.callbacks_mutex);
+            for (auto& [id, finish] : iopub.cell_end_callbacks)
+            {
+                finish();
+            }
+        }
+        std::lock_guard<std::recursive_mutex> lock(iopub.mutex);
+        iopub.in_cell = false;
+    }
+
+    std::size_t add_cell_end_callback(std::function<void()> finish)
+    {
+        iopub_state& iopub = state();
+        std::lock_guard<std::mutex> callbacks_lock(iopub.callbacks_mutex);
+        const std::size_t id = ++iopub.next_callback;
+        iopub.cell_end_callbacks.emplace_back(id, std::move(finish));
+        return id;
+    }
+
+    void remove_cell_end_callback(std::size_t id)
+    {
+        iopub_state& iopub = state();
+        std::lock_guard<std::mutex> callbacks_lock(iopub.callbacks_mutex);
+        auto& callbacks = iopub.cell_end_callbacks;
+        callbacks.erase(
+            std::remove_if(
+                callbacks.begin(),
+                callbacks.end(),
+                [id](const auto& entry)
+                {
+                    return entry.first == id;
+                }
+            ),
+            callbacks.end()
+        );
+    }
+}
@@ -0,0 +1,229 @@
+/************************************************************************************
+ * Copyright (c) 2025, xeus-cpp contributors                                        *
+ *                                                                                  *
+ * Distributed under the terms of the BSD 3-Clause License.                         *
+ *                                                                                  *
+ * The full license is in the file LICENSE, distributed with this software.         *
+ ************************************************************************************/
+
+#include <cstdio>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <CppInterOp/CppInterOp.h>
+
+#include "xlive_output.hpp"
+
+#if !defined(_WIN32) && !defined(__EMSCRIPTEN__)
+#include <cerrno>
+#include <fcntl.h>
+#include <poll.h>
+#include <unistd.h>
+#define XEUS_CPP_LIVE_OUTPUT_PIPE
+#endif
+
+namespace xcpp
+{
+    namespace
+    {
+#ifdef XEUS_CPP_LIVE_OUTPUT_PIPE
+        constexpr std::size_t chunk_size = 16384;
+        // Period at which output buffered by the C library is pushed to the
+        // pipe when the cell writes nothing else.
+        constexpr int flush_interval_ms = 100;
+#endif
+
+        Cpp::CaptureStreamKind capture_kind(std::FILE* stream)
+        {
+            return stream == stderr ? Cpp::kStdErr : Cpp::kStdOut;
+        }
+
+        std::size_t utf8_sequence_length(unsigned char lead)
+        {
+            if ((lead >> 5) == 0x6)
+            {
+                return 2;
+            }
+            if ((lead >> 4) == 0xE)
+            {
+                return 3;
+            }
+            if ((lead >> 3) == 0x1E)
+            {
+                return 4;
+            }
+            return 1;
+        }
+    }
+
+    std::size_t xlive_output::complete_utf8_prefix(const std::string& data)
+    {
+        std::size_t continuation = 0;
+        for (std::size_t i = data.size(); i > 0 && continuation < 4; --i)
+        {
+            const auto c = static_cast<unsigned char>(data[i - 1]);
+            if ((c & 0xC0) != 0x80)
+            {
+                return continuation + 1 >= utf8_sequence_length(c) ? data.size() : i - 1;
+            }
+            ++continuation;
+        }
+        // Not valid UTF-8, there is no point in holding it back.
+        return data.size();
+    }
+
+#ifdef XEUS_CPP_LIVE_OUTPUT_PIPE
+
+    xlive_output::xlive_output(callback_type callback, std::FILE* stream)
+        : m_callback(std::move(callback))
+        , m_stream(stream)
+        , m_fd(fileno(stream))
+        , m_read_fd(-1)
+        , m_saved_fd(-1)
+        , m_stopping(false)
+    {
+        std::fflush(m_stream);
+        int fds[2];
+        if (pipe(fds) != 0)
+        {
+            Cpp::BeginStdStreamCapture(capture_kind(m_stream));
+            return;
+        }
+        m_saved_fd = dup(m_fd);
+        if (m_saved_fd < 0 || dup2(fds[1], m_fd) < 0)
+        {
+            if (m_saved_fd >= 0)
+            {
+                close(m_saved_fd);
+                m_saved_fd = -1;
+            }
+            close(fds[0]);
+            close(fds[1]);
+            Cpp::BeginStdStreamCapture(capture_kind(m_stream));
+            return;
+        }
+        // The write end is only referenced by the captured file descriptor,
+        // so that restoring it is enough for the reader to see the end of
+        // file.
+        close(fds[1]);
+        m_read_fd = fds[0];
+        fcntl(m_read_fd, F_SETFD, FD_CLOEXEC);
+        fcntl(m_saved_fd, F_SETFD, FD_CLOEXEC);
+        m_reader = std::thread(&xlive_output::read_loop, this);
+    }
+
+    xlive_output::~xlive_output()
+    {
+        if (m_saved_fd < 0)
+        {
+            std::string out = Cpp::EndStdStreamCapture();
+            if (!out.empty())
+            {
+                m_callback(out);
+            }
+            return;
+        }
+        std::fflush(m_stream);
+        dup2(m_saved_fd, m_fd);
+        close(m_saved_fd);
+        // Processes started by the cell may still hold the write end, the
+        // reader only drains what is already in the pipe.
+        m_stopping = true;
+        m_reader.join();
+        close(m_read_fd);
+    }
+
+    void xlive_output::read_loop()
+    {
+        std::vector<char> buffer(chunk_size);
+        std::string pending;
+        auto forward = [this](const std::string& chunk)
+        {
+            try
+            {
+                m_callback(chunk);
+            }
+            catch (...)
+            {
+            }
+        };
+
+        while (true)
+        {
+            const bool stopping = m_stopping;
+            pollfd pfd = {m_read_fd, POLLIN, 0};
+            const int ready = poll(&pfd, 1, stopping ? 0 : flush_interval_ms);
+            if (ready < 0 && errno == EINTR)
+            {
+                continue;
+            }
+            if (ready < 0 || (ready == 0 && stopping))
+            {
+                break;
+            }
+            if (ready == 0)
+            {
+                // The pipe is empty and can hold more than the stdio buffer,
+                // so this cannot block on the reader itself. The lock is only
+                // tried, the cell may hold it.
+                if (ftrylockfile(m_stream) == 0)
+                {
+                    std::fflush(m_stream);
+                    funlockfile(m_stream);
+                }
+                continue;
+            }
+
+            const ssize_t count = read(m_read_fd, buffer.data(), buffer.size());
+            if (count < 0 && errno == EINTR)
+            {
+                continue;
+            }
+            if (count <= 0)
+            {
+                break;
+            }
+            pending.append(buffer.data(), static_cast<std::size_t>(count));
+            // Multibyte characters split across reads are sent in one piece.
+            const std::size_t length = complete_utf8_prefix(pending);
+            if (length != 0)
+            {
+                forward(pending.substr(0, length));
+                pending.erase(0, length);
+            }
+        }
+        if (!pending.empty())
+        {
+            forward(pending);
+        }
+    }
+
+#else
+
+    xlive_output::xlive_output(callback_type callback, std::FILE* stream)
+        : m_callback(std::move(callback))
+        , m_stream(stream)
+        , m_fd(-1)
+        , m_read_fd(-1)
+        , m_saved_fd(-1)
+        , m_stopping(false)
+    {
+        Cpp::BeginStdStreamCapture(capture_kind(m_stream));
+    }
+
+    xlive_output::~xlive_output()
+    {
+        std::string out = Cpp::EndStdStreamCapture();
+        if (!out.empty())
+        {
+            m_callback(out);
+        }
+    }
+
+    void xlive_output::read_loop()
+    {
+    }
+
+#endif
+}
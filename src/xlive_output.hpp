@@ -0,0 +1,68 @@
+/************************************************************************************
+ * Copyright (c) 2025, xeus-cpp contributors                                        *
+ *                                                                                  *
+ * Distributed under the terms of the BSD 3-Clause License.                         *
+ *                                                                                  *
+ * The full license is in the file LICENSE, distributed with this software.         *
+ ************************************************************************************/
+
+#ifndef XEUS_CPP_LIVE_OUTPUT_HPP
+#define XEUS_CPP_LIVE_OUTPUT_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <cstdio>
+#include <functional>
+#include <string>
+#include <thread>
+
+#include "xeus-cpp/xeus_cpp_config.hpp"
+
+namespace xcpp
+{
+    /****************
+     * xlive_output *
+     ****************/
+
+    // Forwards what is written to the process stdout or stderr while alive,
+    // instead of the whole output once the cell completes. The file descriptor is
+    // replaced with a pipe drained by a reader thread, which calls
+    // `callback` with each chunk in order. The pipe bounds the memory used:
+    // a writer faster than the callback blocks until the chunks are handled.
+    // Where pipes are not available, the output is captured and forwarded
+    // when the object is destroyed. The callback must not write to stdout,
+    // including through streams tied to std::cout, while the cell holds it.
+    // Streams captured together must be released in reverse order.
+    class XEUS_CPP_API xlive_output
+    {
+    public:
+
+        using callback_type = std::function<void(const std::string&)>;
+
+        explicit xlive_output(callback_type callback, std::FILE* stream = stdout);
+        ~xlive_output();
+
+        xlive_output(const xlive_output&) = delete;
+        xlive_output& operator=(const xlive_output&) = delete;
+        xlive_output(xlive_output&&) = delete;
+        xlive_output& operator=(xlive_output&&) = delete;
+
+        // Length of the longest prefix of `data` that does not end in the
+        // middle of a UTF-8 sequence.
+        static std::size_t complete_utf8_prefix(const std::string& data);
+
+    private:
+
+        void read_loop();
+
+        callback_type m_callback;
+        std::FILE* m_stream;
+        int m_fd;
+        int m_read_fd;
+        int m_saved_fd;
+        std::atomic<bool> m_stopping;
+        std::thread m_reader;
+    };
+}
+
+#endif
@@ -0,0 +1,241 @@
+/************************************************************************************
+ * Copyright (c) 2025, xeus-cpp contributors                                        *
+ *                                                                                  *
+ * Distributed under the terms of the BSD 3-Clause License.                         *
+ *                                                                                  *
+ * The full license is in the file LICENSE, distributed with this software.         *
+ ************************************************************************************/
+
+#include <cstddef>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <system_error>
+#include <utility>
+
+#include "xlocal_docs.hpp"
+
+namespace fs = std::filesystem;
+
+namespace xcpp
+{
+    namespace
+    {
+        std::string read_file(const fs::path& path)
+        {
+            std::ifstream file(path, std::ios::binary);
+            return std::string(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+        }
+
+        // Whether `path` is `directory` or lies under it, once both are
+        // normalized.
+        bool is_within(const fs::path& path, const fs::path& directory)
+        {
+            const fs::path relative = path.lexically_normal().lexically_relative(directory.lexically_normal());
+            return !relative.empty() && *relative.begin() != "..";
+        }
+
+        bool is_tag_end(const std::string& html, std::size_t pos)
+        {
+            return pos >= html.size() || html[pos] == '>' || html[pos] == ' ' || html[pos] == '\t'
+                   || html[pos] == '\n' || html[pos] == '/';
+        }
+
+        // Content of the element whose start tag begins at `start`, nested
+        // elements of the same name included.
+        std::string element_content(const std::string& html, std::size_t start)
+        {
+            std::size_t name_end = start + 1;
+            while (!is_tag_end(html, name_end))
+            {
+                ++name_end;
+            }
+            const std::string name = html.substr(start + 1, name_end - start - 1);
+            const std::size_t content_start = html.find('>', start);
+            if (name.empty() || content_start == std::string::npos)
+            {
+                return "";
+            }
+
+            std::size_t depth = 1;
+            std::size_t pos = content_start + 1;
+            while (pos < html.size())
+            {
+                pos = html.find('<', pos);
+                if (pos == std::string::npos)
+                {
+                    break;
+                }
+                const bool closing = pos + 1 < html.size() && html[pos + 1] == '/';
+                const std::size_t name_start = pos + (closing ? 2 : 1);
+                if (html.compare(name_start, name.size(), name) == 0 && is_tag_end(html, name_start + name.size()))
+                {
+                    depth = closing ? depth - 1 : depth + 1;
+                    if (depth == 0)
+                    {
+                        return html.substr(content_start + 1, pos - content_start - 1);
+                    }
+                }
+                ++pos;
+            }
+            return html.substr(content_start + 1);
+        }
+
+        void remove_elements(std::string& html, const std::string& name)
+        {
+            const std::string open = "<" + name;
+            const std::string close = "</" + name + ">";
+            std::size_t start = html.find(open);
+            while (start != std::string::npos)
+            {
+                if (!is_tag_end(html, start + open.size()))
+                {
+                    start = html.find(open, start + 1);
+                    continue;
+                }
+                const std::size_t end = html.find(close, start);
+                html.erase(start, end == std::string::npos ? std::string::npos : end + close.size() - start);
+                start = html.find(open, start);
+            }
+        }
+    }
+
+    xlocal_docs::xlocal_docs(const std::string& directory, std::size_t capacity)
+        : m_directory(directory)
+        , m_capacity(capacity)
+        , m_hits(0)
+    {
+    }
+
+    const fs::path& xlocal_docs::directory() const
+    {
+        return m_directory;
+    }
+
+    nl::json xlocal_docs::lookup(const std::string& url)
+    {
+        fs::path path;
+        if (m_directory.empty() || !find_page(url, path))
+        {
+            return nl::json::object();
+        }
+        std::error_code ec;
+        const auto write_time = fs::last_write_time(path, ec);
+
+        auto it = m_entries.find(url);
+        if (it != m_entries.end() && it->second.path == path && it->second.write_time == write_time)
+        {
+            ++m_hits;
+            m_lru.splice(m_lru.begin(), m_lru, it->second.lru_it);
+            return it->second.data;
+        }
+
+        nl::json data;
+        const std::string content = read_file(path);
+        if (path.extension() == ".md")
+        {
+            data = nl::json::object({{"text/plain", content}, {"text/markdown", content}});
+        }
+        else
+        {
+            data = nl::json::object({{"text/plain", url}, {"text/html", extract_html(content)}});
+        }
+
+        if (it != m_entries.end())
+        {
+            it->second.path = path;
+            it->second.write_time = write_time;
+            it->second.data = data;
+            m_lru.splice(m_lru.begin(), m_lru, it->second.lru_it);
+            return data;
+        }
+        if (m_entries.size() >= m_capacity)
+        {
+            m_entries.erase(m_lru.back());
+            m_lru.pop_back();
+        }
+        m_lru.push_front(url);
+        m_entries.emplace(url, entry{path, write_time, data, m_lru.begin()});
+        return data;
+    }
+
+    std::size_t xlocal_docs::hits() const
+    {
+        return m_hits;
+    }
+
+    std::size_t xlocal_docs::entries() const
+    {
+        return m_entries.size();
+    }
+
+    std::string xlocal_docs::relative_path(const std::string& url)
+    {
+        std::string res = url.substr(0, url.find_first_of("?#"));
+        const std::size_t scheme = res.find("://");
+        if (scheme != std::string::npos)
+        {
+            res.erase(0, scheme + 3);
+        }
+        // file:///path and scheme-less URLs start with the root.
+        res.erase(0, res.find_first_not_of('/'));
+        while (!res.empty() && res.back() == '/')
+        {
+            res.pop_back();
+        }
+        // Pages outside of the directory are not served.
+        if (res.find("..") != std::string::npos || fs::path(res).has_root_path())
+        {
+            return "";
+        }
+        return res;
+    }
+
+    std::string xlocal_docs::extract_html(const std::string& html)
+    {
+        // The article of MediaWiki pages such as the ones of cppreference,
+        // then the main element, then the body.
+        std::string res = html;
+        std::size_t start = html.find("id=\"mw-content-text\"");
+        start = start == std::string::npos ? std::string::npos : html.rfind('<', start);
+        for (const char* tag : {"<main", "<body"})
+        {
+            for (std::size_t pos = html.find(tag); start == std::string::npos && pos != std::string::npos;
+                 pos = html.find(tag, pos + 1))
+            {
+                if (is_tag_end(html, pos + std::char_traits<char>::length(tag)))
+                {
+                    start = pos;
+                }
+            }
+        }
+        if (start != std::string::npos)
+        {
+            res = element_content(html, start);
+        }
+        remove_elements(res, "script");
+        remove_elements(res, "style");
+        return res;
+    }
+
+    bool xlocal_docs::find_page(const std::string& url, fs::path& path) const
+    {
+        const std::string relative = relative_path(url);
+        if (relative.empty())
+        {
+            return false;
+        }
+        std::error_code ec;
+        for (const char* suffix : {".md", ".html", "", "/index.html"})
+        {
+            fs::path candidate = m_directory / (relative + suffix);
+            if (is_within(candidate, m_directory) && fs::is_regular_file(candidate, ec))
+            {
+                path = std::move(candidate);
+                return true;
+            }
+        }
+        return false;
+    }
+}
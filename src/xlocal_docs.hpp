@@ -0,0 +1,81 @@
+/************************************************************************************
+ * Copyright (c) 2025, xeus-cpp contributors                                        *
+ *                                                                                  *
+ * Distributed under the terms of the BSD 3-Clause License.                         *
+ *                                                                                  *
+ * The full license is in the file LICENSE, distributed with this software.         *
+ ************************************************************************************/
+
+#ifndef XEUS_CPP_LOCAL_DOCS_HPP
+#define XEUS_CPP_LOCAL_DOCS_HPP
+
+#include <cstddef>
+#include <filesystem>
+#include <list>
+#include <string>
+#include <unordered_map>
+
+#include <nlohmann/json.hpp>
+
+#include "xeus-cpp/xeus_cpp_config.hpp"
+
+namespace nl = nlohmann;
+
+namespace xcpp
+{
+    /***************
+     * xlocal_docs *
+     ***************/
+
+    // Documentation pages installed locally, laid out as a mirror of their
+    // URLs: the page of https://host/path is host/path.md, host/path.html,
+    // host/path or host/path/index.html in the directory, as produced by
+    // `wget --mirror`. Pages are found from the URLs of the tagfile index
+    // and embedded in the inspect replies instead of loading the remote
+    // page in an iframe. The rendered pages are kept in a cache, the least
+    // recently used ones are evicted beyond the capacity.
+    class XEUS_CPP_API xlocal_docs
+    {
+    public:
+
+        explicit xlocal_docs(const std::string& directory, std::size_t capacity = 16);
+
+        const std::filesystem::path& directory() const;
+
+        // Mime bundle of the local page of `url`, empty if there is none:
+        // text/markdown for Markdown pages, text/html with the main content
+        // of HTML pages.
+        nl::json lookup(const std::string& url);
+
+        std::size_t hits() const;
+        std::size_t entries() const;
+
+        // Path of the page of `url` relative to the directory, without the
+        // scheme, the query and the fragment.
+        static std::string relative_path(const std::string& url);
+        // Main content of an HTML page, scripts and styles left out.
+        static std::string extract_html(const std::string& html);
+
+    private:
+
+        struct entry
+        {
+            std::filesystem::path path;
+            std::filesystem::file_time_type write_time;
+            nl::json data;
+            std::list<std::string>::iterator lru_it;
+        };
+
+        bool find_page(const std::string& url, std::filesystem::path& path) const;
+
+        std::filesystem::path m_directory;
+        std::size_t m_capacity;
+        std::size_t m_hits;
+
+        // Most recently used URLs are at the front.
+        std::list<std::string> m_lru;
+        std::unordered_map<std::string, entry> m_entries;
+    };
+}
+
+#endif
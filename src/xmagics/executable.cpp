@@ -0,0 +1,206 @@
+/************************************************************************************
+ * Copyright (c) 2025, xeus-cpp contributors                                        *
+ *                                                                                  *
+ * Distributed under the terms of the BSD 3-Clause License.                         *
+ *                                                                                  *
+ * The full license is in the file LICENSE, distributed with this software.         *
+ ************************************************************************************/
+
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <iterator>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "executable.hpp"
+#include "../xcompiler.hpp"
+#include "../xparser.hpp"
+
+namespace fs = std::filesystem;
+
+namespace xcpp
+{
+    namespace
+    {
+        void get_options(argparser& argpars)
+        {
+            argpars.add_description("Build a native executable from the declarations of the kernel and the cell");
+            argpars.add_argument("filename").help("path of the executable to build").required();
+            // Add custom help (does not call `exit` avoiding to restart the kernel)
+            argpars.add_argument("-h", "--help")
+                .action(
+                    [&](const std::string& /*unused*/)
+                    {
+                        std::cout << argpars.help().str();
+                        std::cout << "\nThe other options are passed to the compiler, -O3 is used unless "
+                                     "an optimization level is given.\n";
+                    }
+                )
+                .default_value(false)
+                .help("shows help message")
+                .implicit_value(true)
+                .nargs(0);
+        }
+
+        std::string format_size(std::uintmax_t size)
+        {
+            static const char* units[] = {"B", "KiB", "MiB", "GiB"};
+            double value = static_cast<double>(size);
+            std::size_t unit = 0;
+            while (value >= 1024. && unit < 3)
+            {
+                value /= 1024.;
+                ++unit;
+            }
+            std::ostringstream os;
+            os << std::fixed << std::setprecision(unit == 0 ? 0 : 1) << value << " " << units[unit];
+            return os.str();
+        }
+    }
+
+    executable::executable(
+        const std::vector<std::string>& interpreter_args,
+        const std::vector<std::string>& declarations
+    )
+        : m_interpreter_args(interpreter_args)
+        , m_declarations(declarations)
+    {
+    }
+
+    std::string executable::generate_source(const std::string& cell) const
+    {
+        std::ostringstream source;
+        for (const std::string& declaration : m_declarations)
+        {
+            source << declaration << "\n";
+        }
+
+        std::ostringstream body;
+        for (const code_chunk& chunk : split_code(cell))
+        {
+            if (chunk.kind == chunk_kind::preprocessor || chunk.kind == chunk_kind::definition)
+            {
+                source << chunk.code << "\n";
+            }
+            else
+            {
+                body << chunk.code << "\n";
+            }
+        }
+
+        source << "\nint main(int argc, char* argv[])\n{\n"
+               << "(void)argc;\n(void)argv;\n"
+               << body.str() << "\n;\nreturn 0;\n}\n";
+        return source.str();
+    }
+
+    void executable::operator()(const std::string& line, const std::string& cell)
+    {
+        // The magic name and the file name are handled by the parser, every
+        // other word goes to the compiler.
+        std::istringstream iss(line);
+        std::vector<std::string> words((std::istream_iterator<std::string>(iss)), std::istream_iterator<std::string>());
+        std::string options;
+        std::vector<std::string> user_flags;
+        for (std::size_t i = 0; i < words.size(); ++i)
+        {
+            if (i == 0 || words[i] == "-h" || words[i] == "--help" || words[i][0] != '-')
+            {
+                options += words[i] + " ";
+            }
+            else
+            {
+                user_flags.push_back(words[i]);
+            }
+        }
+
+        argparser argpars("executable", XEUS_CPP_VERSION, argparse::default_arguments::none);
+        get_options(argpars);
+        argpars.parse(options);
+        if (argpars["-h"] == true)
+        {
+            return;
+        }
+        const std::string filename = argpars.get<std::string>("filename");
+
+        const std::string compiler = find_host_compiler();
+        if (compiler.empty())
+        {
+            std::cerr << "No C++ compiler found, set CXX or add clang++ to PATH" << std::endl;
+            return;
+        }
+
+        // The source is compiled from a private directory, where other users
+        // cannot plant or replace it.
+        const std::string directory = make_private_directory("xcpp_executable_");
+        if (directory.empty())
+        {
+            std::cerr << "Could not create a temporary directory for the generated source" << std::endl;
+            return;
+        }
+        const std::string source_path = (fs::path(directory) / "main.cpp").string();
+        {
+            std::ofstream source(source_path);
+            source << generate_source(cell);
+            if (!source)
+            {
+                std::cerr << "Could not write " << source_path << std::endl;
+                std::error_code ec;
+                fs::remove_all(directory, ec);
+                return;
+            }
+        }
+
+        std::vector<std::string> args = {compiler};
+        std::vector<std::string> flags = host_compiler_flags(m_interpreter_args);
+        args.insert(args.end(), flags.begin(), flags.end());
+        const bool has_optimization_level = std::any_of(
+            user_flags.begin(),
+            user_flags.end(),
+            [](const std::string& flag)
+            {
+                return flag.compare(0, 2, "-O") == 0;
+            }
+        );
+        if (!has_optimization_level)
+        {
+            args.push_back("-O3");
+        }
+        args.insert(args.end(), user_flags.begin(), user_flags.end());
+        args.insert(args.end(), {"-x", "c++", source_path, "-o", filename});
+
+        auto start = std::chrono::steady_clock::now();
+        std::string output;
+        const int status = run_program(args, output);
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+        std::error_code ec;
+        if (status != 0)
+        {
+            std::cerr << output;
+            std::cerr << "Compilation of " << filename << " failed, the generated source is kept in "
+                      << source_path << std::endl;
+            return;
+        }
+        fs::remove_all(directory, ec);
+        if (!output.empty())
+        {
+            std::cerr << output;
+        }
+
+        std::uintmax_t size = fs::file_size(filename, ec);
+        std::cout << "Built " << filename << " in " << std::fixed << std::setprecision(2) << elapsed.count()
+                  << " s" << (ec ? std::string() : " (" + format_size(size) + ")") << "\n";
+        std::cout << "Command:";
+        for (auto it = args.begin(); it != args.end() && *it != "-x"; ++it)
+        {
+            std::cout << " " << *it;
+        }
+        std::cout << std::endl;
+    }
+}
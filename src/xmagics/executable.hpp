@@ -0,0 +1,43 @@
+/************************************************************************************
+ * Copyright (c) 2025, xeus-cpp contributors                                        *
+ *                                                                                  *
+ * Distributed under the terms of the BSD 3-Clause License.                         *
+ *                                                                                  *
+ * The full license is in the file LICENSE, distributed with this software.         *
+ ************************************************************************************/
+
+#ifndef XEUS_CPP_EXECUTABLE_MAGIC_HPP
+#define XEUS_CPP_EXECUTABLE_MAGIC_HPP
+
+#include <string>
+#include <vector>
+
+#include "xeus-cpp/xmagics.hpp"
+#include "xeus-cpp/xoptions.hpp"
+
+namespace xcpp
+{
+    class executable : public xmagic_cell
+    {
+    public:
+
+        // `declarations` are the declarations of the cells executed so far,
+        // both are owned by the interpreter.
+        XEUS_CPP_API
+        executable(const std::vector<std::string>& interpreter_args, const std::vector<std::string>& declarations);
+
+        XEUS_CPP_API
+        void operator()(const std::string& line, const std::string& cell) override;
+
+        // Builds the translation unit: the declarations at namespace scope,
+        // followed by a main function running the statements of the cell.
+        XEUS_CPP_API
+        std::string generate_source(const std::string& cell) const;
+
+    private:
+
+        const std::vector<std::string>& m_interpreter_args;
+        const std::vector<std::string>& m_declarations;
+    };
+}
+#endif
@@ -0,0 +1,282 @@
+/************************************************************************************
+ * Copyright (c) 2025, xeus-cpp contributors                                        *
+ *                                                                                  *
+ * Distributed under the terms of the BSD 3-Clause License.                         *
+ *                                                                                  *
+ * The full license is in the file LICENSE, distributed with this software.         *
+ ************************************************************************************/
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <CppInterOp/CppInterOp.h>
+
+#include "execution.hpp"
+#include "../xinterrupt.hpp"
+
+namespace xcpp
+{
+    namespace
+    {
+        // Total duration of one run when the number of loops is not given.
+        constexpr double min_run_duration = 0.2;
+        constexpr unsigned long max_loops = 1000000000UL;
+
+        void get_options(argparser& argpars)
+        {
+            argpars.add_description("Time execution of a C++ statement or expression");
+            argpars.add_argument("-n", "--number")
+                .help("execute the given statement n times in a loop. If n is not provided, n is determined so as to get sufficient accuracy.")
+                .default_value(0)
+                .scan<'i', int>();
+            argpars.add_argument("-r", "--repeat")
+                .help("repeat the loop iteration r times and report statistics over the runs.")
+                .default_value(7)
+                .scan<'i', int>();
+            argpars.add_argument("-p", "--precision")
+                .help("use a precision of p digits to display the timing result")
+                .default_value(3)
+                .scan<'i', int>();
+            // Add custom help (does not call `exit` avoiding to restart the kernel)
+            argpars.add_argument("-h", "--help")
+                .action(
+                    [&](const std::string& /*unused*/)
+                    {
+                        std::cout << argpars.help().str();
+                    }
+                )
+                .default_value(false)
+                .help("shows help message")
+                .implicit_value(true)
+                .nargs(0);
+        }
+
+        // Splits `line` into the magic name followed by its options, and the
+        // code to time, whose spacing must be preserved.
+        void split_options(const std::string& line, std::string& options, std::string& code)
+        {
+            static const std::vector<std::string> with_value = {"-n", "--number", "-r", "--repeat", "-p", "--precision"};
+            static const std::vector<std::string> flags = {"-h", "--help"};
+
+            auto next_token = [&line](std::size_t& pos)
+            {
+                pos = line.find_first_not_of(" \t", pos);
+                if (pos == std::string::npos)
+                {
+                    pos = line.size();
+                    return std::string();
+                }
+                std::size_t end = line.find_first_of(" \t", pos);
+                end = end == std::string::npos ? line.size() : end;
+                std::string token = line.substr(pos, end - pos);
+                pos = end;
+                return token;
+            };
+
+            std::size_t pos = 0;
+            options = next_token(pos);
+            while (true)
+            {
+                std::size_t start = pos;
+                std::string token = next_token(pos);
+                if (std::find(with_value.begin(), with_value.end(), token) != with_value.end())
+                {
+                    options += " " + token + " " + next_token(pos);
+                }
+                else if (std::find(flags.begin(), flags.end(), token) != flags.end())
+                {
+                    options += " " + token;
+                }
+                else
+                {
+                    pos = start;
+                    break;
+                }
+            }
+            std::size_t begin = line.find_first_not_of(" \t", pos);
+            code = begin == std::string::npos ? "" : line.substr(begin);
+        }
+
+        double percentile(const std::vector<double>& sorted, double p)
+        {
+            std::size_t rank = static_cast<std::size_t>(std::ceil(p / 100. * sorted.size()));
+            return sorted[std::max<std::size_t>(rank, 1) - 1];
+        }
+    }
+
+    void timeit::operator()(const std::string& line)
+    {
+        std::string options;
+        std::string code;
+        split_options(line, options, code);
+        if (code.empty() && options.find("-h") == std::string::npos)
+        {
+            std::cerr << "UsageError: %timeit requires a statement to time" << std::endl;
+            return;
+        }
+        execute(options, "", code);
+    }
+
+    void timeit::operator()(const std::string& line, const std::string& cell)
+    {
+        // As in IPython, the rest of the line is setup code run once per run.
+        std::string options;
+        std::string setup;
+        split_options(line, options, setup);
+        execute(options, setup, cell);
+    }
+
+    std::string timeit::format_time(double seconds, std::size_t precision)
+    {
+        static const char* units[] = {"s", "ms", "us", "ns"};
+        std::size_t order = 0;
+        if (seconds > 0.)
+        {
+            order = std::min<std::size_t>(
+                static_cast<std::size_t>(std::max(0., std::ceil(-std::log10(seconds) / 3.))),
+                3
+            );
+        }
+        std::ostringstream os;
+        os << std::setprecision(static_cast<int>(precision)) << seconds * std::pow(1000., order) << " "
+           << units[order];
+        return os.str();
+    }
+
+    void timeit::execute(const std::string& options, const std::string& setup, const std::string& code)
+    {
+        argparser argpars("timeit", XEUS_CPP_VERSION, argparse::default_arguments::none);
+        get_options(argpars);
+        argpars.parse(options);
+        if (argpars["-h"] == true)
+        {
+            return;
+        }
+
+        const int number = argpars.get<int>("-n");
+        const int repeat = std::max(argpars.get<int>("-r"), 1);
+        const std::size_t precision = static_cast<std::size_t>(std::max(argpars.get<int>("-p"), 1));
+
+        // Compilation happens here, before any measurement.
+        timer_fn fn = compile(setup, code);
+        if (fn == nullptr)
+        {
+            return;
+        }
+
+        double elapsed = 0.;
+        auto run = [fn, &elapsed](unsigned long n)
+        {
+            return run_interruptible(
+                [fn, n, &elapsed]()
+                {
+                    elapsed = fn(n);
+                }
+            );
+        };
+
+        // Warmup, then grow the loop count until a run is long enough for
+        // the clock resolution to be negligible.
+        if (!run(1))
+        {
+            std::cerr << "Interrupted" << std::endl;
+            return;
+        }
+        unsigned long loops = static_cast<unsigned long>(std::max(number, 0));
+        if (loops == 0)
+        {
+            loops = 1;
+            while (true)
+            {
+                if (!run(loops))
+                {
+                    std::cerr << "Interrupted" << std::endl;
+                    return;
+                }
+                if (elapsed >= min_run_duration || loops >= max_loops)
+                {
+                    break;
+                }
+                loops *= 10;
+            }
+        }
+
+        std::vector<double> per_loop;
+        per_loop.reserve(static_cast<std::size_t>(repeat));
+        for (int i = 0; i < repeat; ++i)
+        {
+            if (!run(loops))
+            {
+                std::cerr << "Interrupted" << std::endl;
+                return;
+            }
+            per_loop.push_back(elapsed / static_cast<double>(loops));
+        }
+
+        double mean = 0.;
+        for (double t : per_loop)
+        {
+            mean += t;
+        }
+        mean /= static_cast<double>(per_loop.size());
+        double variance = 0.;
+        for (double t : per_loop)
+        {
+            variance += (t - mean) * (t - mean);
+        }
+        const double stddev = per_loop.size() > 1 ? std::sqrt(variance / static_cast<double>(per_loop.size() - 1))
+                                                  : 0.;
+        std::sort(per_loop.begin(), per_loop.end());
+
+        std::cout << format_time(mean, precision) << " +- " << format_time(stddev, precision)
+                  << " per loop (mean +- std. dev. of " << repeat << " run" << (repeat == 1 ? "" : "s") << ", "
+                  << loops << " loop" << (loops == 1 ? "" : "s") << " each)\n"
+                  << "min " << format_time(per_loop.front(), precision) << ", median "
+                  << format_time(percentile(per_loop, 50.), precision) << ", p95 "
+                  << format_time(percentile(per_loop, 95.), precision) << std::endl;
+    }
+
+    timeit::timer_fn timeit::compile(const std::string& setup, const std::string& code)
+    {
+        static std::size_t counter = 0;
+        const std::string name = "__xcpp_timeit_" + std::to_string(counter++);
+
+        std::ostringstream function;
+        function << "#include <chrono>\n"
+                 << "extern \"C\" double " << name << "(unsigned long __xcpp_n)\n"
+                 << "{\n"
+                 << setup << "\n;\n"
+                 << "auto __xcpp_start = std::chrono::steady_clock::now();\n"
+                 << "for (unsigned long __xcpp_i = 0; __xcpp_i < __xcpp_n; ++__xcpp_i)\n"
+                 << "{\n"
+                 << code << "\n;\n"
+                 << "}\n"
+                 << "auto __xcpp_end = std::chrono::steady_clock::now();\n"
+                 << "return std::chrono::duration<double>(__xcpp_end - __xcpp_start).count();\n"
+                 << "}\n";
+
+        Cpp::BeginStdStreamCapture(Cpp::kStdErr);
+        const int failed = Cpp::Process(function.str().c_str());
+        std::string diagnostics = Cpp::EndStdStreamCapture();
+        if (failed)
+        {
+            std::cerr << diagnostics;
+            return nullptr;
+        }
+
+        // Resolving the address materializes the function in the JIT.
+        Cpp::TCppFuncAddr_t address = Cpp::GetFunctionAddress(Cpp::GetNamed(name));
+        if (address == nullptr)
+        {
+            std::cerr << "Could not compile the statement to time" << std::endl;
+            return nullptr;
+        }
+        return reinterpret_cast<timer_fn>(address);
+    }
+}
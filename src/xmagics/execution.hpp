@@ -0,0 +1,45 @@
+/************************************************************************************
+ * Copyright (c) 2025, xeus-cpp contributors                                        *
+ *                                                                                  *
+ * Distributed under the terms of the BSD 3-Clause License.                         *
+ *                                                                                  *
+ * The full license is in the file LICENSE, distributed with this software.         *
+ ************************************************************************************/
+
+#ifndef XEUS_CPP_EXECUTION_MAGIC_HPP
+#define XEUS_CPP_EXECUTION_MAGIC_HPP
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#include "xeus-cpp/xmagics.hpp"
+#include "xeus-cpp/xoptions.hpp"
+
+namespace xcpp
+{
+    class timeit : public xmagic_line_cell
+    {
+    public:
+
+        XEUS_CPP_API
+        void operator()(const std::string& line) override;
+
+        XEUS_CPP_API
+        void operator()(const std::string& line, const std::string& cell) override;
+
+        // Formats a duration in seconds with the most readable unit.
+        XEUS_CPP_API
+        static std::string format_time(double seconds, std::size_t precision);
+
+    private:
+
+        void execute(const std::string& options, const std::string& setup, const std::string& code);
+
+        // Compiles `code` into a function running it `n` times and returning
+        // the elapsed time in seconds. Returns nullptr on compilation errors.
+        using timer_fn = double (*)(unsigned long);
+        static timer_fn compile(const std::string& setup, const std::string& code);
+    };
+}
+#endif
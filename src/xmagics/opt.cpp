@@ -0,0 +1,191 @@
+/************************************************************************************
+ * Copyright (c) 2025, xeus-cpp contributors                                        *
+ *                                                                                  *
+ * Distributed under the terms of the BSD 3-Clause License.                         *
+ *                                                                                  *
+ * The full license is in the file LICENSE, distributed with this software.         *
+ ************************************************************************************/
+
+#include <iostream>
+#include <iterator>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <CppInterOp/CppInterOp.h>
+
+#include "opt.hpp"
+#include "../xinterrupt.hpp"
+#include "../xparser.hpp"
+
+namespace xcpp
+{
+    namespace
+    {
+        struct capture_guard
+        {
+            std::string out;
+            std::string err;
+
+            capture_guard()
+            {
+                Cpp::BeginStdStreamCapture(Cpp::kStdErr);
+                Cpp::BeginStdStreamCapture(Cpp::kStdOut);
+            }
+
+            ~capture_guard()
+            {
+                out = Cpp::EndStdStreamCapture();
+                err = Cpp::EndStdStreamCapture();
+                std::cout << out;
+                std::cerr << err;
+            }
+        };
+
+        void get_options(argparser& argpars)
+        {
+            argpars.add_description("Compile functions ahead of time with the given code generation flags");
+            argpars.add_argument("--reset")
+                .help("compile the following cells with the interpreter only")
+                .default_value(false)
+                .implicit_value(true);
+            // Add custom help (does not call `exit` avoiding to restart the kernel)
+            argpars.add_argument("-h", "--help")
+                .action(
+                    [&](const std::string& /*unused*/)
+                    {
+                        std::cout << argpars.help().str();
+                        std::cout << "\nThe other options are passed to the compiler, for example "
+                                     "-O3 -march=native -ffast-math.\n";
+                    }
+                )
+                .default_value(false)
+                .help("shows help message")
+                .implicit_value(true)
+                .nargs(0);
+        }
+
+        // Parses the options of the magic and returns the compiler flags.
+        std::vector<std::string> parse_line(const std::string& line, argparser& argpars)
+        {
+            std::istringstream iss(line);
+            std::vector<std::string> words((std::istream_iterator<std::string>(iss)), std::istream_iterator<std::string>());
+            std::string options;
+            std::vector<std::string> flags;
+            for (std::size_t i = 0; i < words.size(); ++i)
+            {
+                if (i == 0 || words[i] == "-h" || words[i] == "--help" || words[i] == "--reset")
+                {
+                    options += words[i] + " ";
+                }
+                else
+                {
+                    flags.push_back(words[i]);
+                }
+            }
+            get_options(argpars);
+            argpars.parse(options);
+            return flags;
+        }
+
+        std::string join(const std::vector<std::string>& words)
+        {
+            std::string res;
+            for (const std::string& word : words)
+            {
+                res += (res.empty() ? "" : " ") + word;
+            }
+            return res;
+        }
+    }
+
+    opt::opt(xoptimizer& optimizer, std::vector<std::string>& declarations)
+        : m_optimizer(optimizer)
+        , m_declarations(declarations)
+    {
+    }
+
+    void opt::operator()(const std::string& line)
+    {
+        argparser argpars("opt", XEUS_CPP_VERSION, argparse::default_arguments::none);
+        std::vector<std::string> flags = parse_line(line, argpars);
+        if (argpars["-h"] == true)
+        {
+            return;
+        }
+
+        if (argpars["--reset"] == true)
+        {
+            m_optimizer.set_flags({});
+            std::cout << "The following cells are compiled by the interpreter only" << std::endl;
+            return;
+        }
+        if (!flags.empty())
+        {
+            m_optimizer.set_flags(flags);
+            std::cout << "Functions defined by the following cells are compiled ahead of time with: "
+                      << join(flags) << std::endl;
+            return;
+        }
+
+        std::cout << "Code generation flags: " << (m_optimizer.active() ? join(m_optimizer.flags()) : "none")
+                  << "\n";
+        for (const auto& [execution_count, pipeline] : m_optimizer.records())
+        {
+            std::cout << "[" << execution_count << "] " << pipeline << "\n";
+        }
+        std::cout << std::flush;
+    }
+
+    void opt::operator()(const std::string& line, const std::string& cell)
+    {
+        argparser argpars("opt", XEUS_CPP_VERSION, argparse::default_arguments::none);
+        std::vector<std::string> flags = parse_line(line, argpars);
+        if (argpars["-h"] == true)
+        {
+            return;
+        }
+        if (flags.empty())
+        {
+            flags = m_optimizer.active() ? m_optimizer.flags() : std::vector<std::string>{"-O3"};
+        }
+
+        std::string jit_code;
+        std::string pipeline;
+        std::string diagnostics;
+        if (!m_optimizer.offload(cell, flags, jit_code, pipeline, diagnostics))
+        {
+            std::cerr << diagnostics << std::flush;
+            return;
+        }
+
+        int failed = 0;
+        bool completed = true;
+        {
+            capture_guard guard;
+            completed = run_interruptible(
+                [&jit_code, &failed]()
+                {
+                    failed = Cpp::Process(jit_code.c_str());
+                }
+            );
+        }
+        if (failed)
+        {
+            return;
+        }
+
+        for (std::string& declaration : split_declarations(cell))
+        {
+            m_declarations.push_back(std::move(declaration));
+        }
+        m_optimizer.record(pipeline);
+        if (!completed)
+        {
+            std::cerr << "Interrupted" << std::endl;
+            return;
+        }
+        std::cout << "[opt] " << pipeline << std::endl;
+    }
+}
@@ -0,0 +1,47 @@
+/************************************************************************************
+ * Copyright (c) 2025, xeus-cpp contributors                                        *
+ *                                                                                  *
+ * Distributed under the terms of the BSD 3-Clause License.                         *
+ *                                                                                  *
+ * The full license is in the file LICENSE, distributed with this software.         *
+ ************************************************************************************/
+
+#ifndef XEUS_CPP_OPT_MAGIC_HPP
+#define XEUS_CPP_OPT_MAGIC_HPP
+
+#include <string>
+#include <vector>
+
+#include "xeus-cpp/xmagics.hpp"
+#include "xeus-cpp/xoptions.hpp"
+
+#include "../xoptimizer.hpp"
+
+namespace xcpp
+{
+    class opt : public xmagic_line_cell
+    {
+    public:
+
+        // Both are owned by the interpreter, `declarations` receives those of
+        // the cells run by the magic.
+        XEUS_CPP_API
+        opt(xoptimizer& optimizer, std::vector<std::string>& declarations);
+
+        // %opt [flags]: sets the code generation flags of the following cells,
+        // shows the current ones and how the last cells were compiled.
+        XEUS_CPP_API
+        void operator()(const std::string& line) override;
+
+        // %%opt [flags]: runs the cell with its functions compiled with the
+        // given flags, or the session flags, or -O3.
+        XEUS_CPP_API
+        void operator()(const std::string& line, const std::string& cell) override;
+
+    private:
+
+        xoptimizer& m_optimizer;
+        std::vector<std::string>& m_declarations;
+    };
+}
+#endif
@@ -0,0 +1,104 @@
+/************************************************************************************
+ * Copyright (c) 2025, xeus-cpp contributors                                        *
+ *                                                                                  *
+ * Distributed under the terms of the BSD 3-Clause License.                         *
+ *                                                                                  *
+ * The full license is in the file LICENSE, distributed with this software.         *
+ ************************************************************************************/
+
+#include <fstream>
+#include <iostream>
+#include <string>
+
+#include "stats.hpp"
+#include "../xcache.hpp"
+#include "../xstats.hpp"
+
+namespace xcpp
+{
+    namespace
+    {
+        void get_options(argparser& argpars)
+        {
+            argpars.add_description("Show the time spent by the kernel in each phase of the requests");
+            argpars.add_argument("--json")
+                .help("print the statistics as JSON")
+                .default_value(false)
+                .implicit_value(true);
+            argpars.add_argument("-o", "--output").help("write the statistics as JSON to the given file");
+            argpars.add_argument("--reset")
+                .help("clear the statistics after showing them")
+                .default_value(false)
+                .implicit_value(true);
+            // Add custom help (does not call `exit` avoiding to restart the kernel)
+            argpars.add_argument("-h", "--help")
+                .action(
+                    [&](const std::string& /*unused*/)
+                    {
+                        std::cout << argpars.help().str();
+                    }
+                )
+                .default_value(false)
+                .help("shows help message")
+                .implicit_value(true)
+                .nargs(0);
+        }
+    }
+
+    kernel_stats::kernel_stats(xstats& stats, const xcell_cache& cell_cache)
+        : m_stats(stats)
+        , m_cell_cache(cell_cache)
+    {
+    }
+
+    nl::json kernel_stats::to_json() const
+    {
+        nl::json res = m_stats.to_json();
+        res["cell_cache"] = {
+            {"enabled", m_cell_cache.enabled()},
+            {"hits", m_cell_cache.hits()},
+            {"misses", m_cell_cache.misses()},
+            {"entries", m_cell_cache.entries()},
+            {"size", m_cell_cache.size()},
+            {"max_size", m_cell_cache.max_size()}
+        };
+        return res;
+    }
+
+    void kernel_stats::operator()(const std::string& line)
+    {
+        argparser argpars("kernel_stats", XEUS_CPP_VERSION, argparse::default_arguments::none);
+        get_options(argpars);
+        argpars.parse(line);
+        if (argpars["-h"] == true)
+        {
+            return;
+        }
+
+        if (auto output = argpars.present("--output"))
+        {
+            std::ofstream out(*output, std::ios::trunc);
+            if (!out)
+            {
+                std::cerr << "Cannot write the statistics to " << *output << std::endl;
+                return;
+            }
+            out << to_json().dump(2) << "\n";
+        }
+        else if (argpars["--json"] == true)
+        {
+            std::cout << to_json().dump(2) << std::endl;
+        }
+        else
+        {
+            std::cout << m_stats.report() << "cell cache: " << m_cell_cache.hits() << " hits, "
+                      << m_cell_cache.misses() << " misses, " << m_cell_cache.entries() << " entries"
+                      << std::endl;
+        }
+
+        if (argpars["--reset"] == true)
+        {
+            m_stats.reset();
+        }
+    }
+}
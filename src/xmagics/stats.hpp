@@ -0,0 +1,47 @@
+/************************************************************************************
+ * Copyright (c) 2025, xeus-cpp contributors                                        *
+ *                                                                                  *
+ * Distributed under the terms of the BSD 3-Clause License.                         *
+ *                                                                                  *
+ * The full license is in the file LICENSE, distributed with this software.         *
+ ************************************************************************************/
+
+#ifndef XEUS_CPP_STATS_MAGIC_HPP
+#define XEUS_CPP_STATS_MAGIC_HPP
+
+#include <string>
+
+#include <nlohmann/json.hpp>
+
+#include "xeus-cpp/xmagics.hpp"
+#include "xeus-cpp/xoptions.hpp"
+
+namespace nl = nlohmann;
+
+namespace xcpp
+{
+    class xcell_cache;
+    class xstats;
+
+    class kernel_stats : public xmagic_line
+    {
+    public:
+
+        XEUS_CPP_API
+        kernel_stats(xstats& stats, const xcell_cache& cell_cache);
+
+        // %kernel_stats [--json] [-o file] [--reset]
+        XEUS_CPP_API
+        void operator()(const std::string& line) override;
+
+        // Request timings and cell cache counters.
+        XEUS_CPP_API
+        nl::json to_json() const;
+
+    private:
+
+        xstats& m_stats;
+        const xcell_cache& m_cell_cache;
+    };
+}
+#endif
@@ -0,0 +1,120 @@
+/************************************************************************************
+ * Copyright (c) 2025, xeus-cpp contributors                                        *
+ *                                                                                  *
+ * Distributed under the terms of the BSD 3-Clause License.                         *
+ *                                                                                  *
+ * The full license is in the file LICENSE, distributed with this software.         *
+ ************************************************************************************/
+
+#include <algorithm>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "who.hpp"
+#include "../xsymbol_index.hpp"
+
+namespace xcpp
+{
+    namespace
+    {
+        void get_options(argparser& argpars)
+        {
+            argpars.add_description("List the names declared by the cells executed so far");
+            argpars.add_argument("kinds")
+                .help("only list these kinds: function, class, enum, template, typedef, variable, namespace")
+                .remaining();
+            argpars.add_argument("-l", "--long")
+                .help("show the kind and the declarations of each name")
+                .default_value(false)
+                .implicit_value(true);
+            // Add custom help (does not call `exit` avoiding to restart the kernel)
+            argpars.add_argument("-h", "--help")
+                .action(
+                    [&](const std::string& /*unused*/)
+                    {
+                        std::cout << argpars.help().str();
+                    }
+                )
+                .default_value(false)
+                .help("shows help message")
+                .implicit_value(true)
+                .nargs(0);
+        }
+    }
+
+    who::who(const xsymbol_index& index)
+        : m_index(index)
+    {
+    }
+
+    std::string who::report(const std::vector<std::string>& kinds, bool long_format) const
+    {
+        std::vector<const xsymbol*> symbols;
+        std::size_t width = 4;
+        for (const auto& [name, symbol] : m_index.symbols())
+        {
+            if (kinds.empty() || std::find(kinds.begin(), kinds.end(), symbol.kind) != kinds.end())
+            {
+                symbols.push_back(&symbol);
+                width = std::max(width, name.size());
+            }
+        }
+        if (symbols.empty())
+        {
+            return "No declarations.\n";
+        }
+
+        std::ostringstream oss;
+        if (!long_format)
+        {
+            for (std::size_t i = 0; i < symbols.size(); ++i)
+            {
+                oss << (i == 0 ? "" : "\t") << symbols[i]->name;
+            }
+            oss << "\n";
+            return oss.str();
+        }
+
+        oss << std::left << std::setw(static_cast<int>(width) + 2) << "Name" << std::setw(11) << "Kind"
+            << std::setw(6) << "Cell" << "Declaration\n";
+        for (const xsymbol* symbol : symbols)
+        {
+            oss << std::setw(static_cast<int>(width) + 2) << symbol->name << std::setw(11) << symbol->kind
+                << std::setw(6) << ("[" + std::to_string(symbol->execution_count) + "]");
+            if (symbol->declarations.empty())
+            {
+                oss << "\n";
+            }
+            for (std::size_t i = 0; i < symbol->declarations.size(); ++i)
+            {
+                if (i != 0)
+                {
+                    oss << std::string(width + 2 + 11 + 6, ' ');
+                }
+                oss << symbol->declarations[i] << "\n";
+            }
+        }
+        return oss.str();
+    }
+
+    void who::operator()(const std::string& line)
+    {
+        argparser argpars("who", XEUS_CPP_VERSION, argparse::default_arguments::none);
+        get_options(argpars);
+        argpars.parse(line);
+        if (argpars["-h"] == true)
+        {
+            return;
+        }
+
+        std::vector<std::string> kinds;
+        if (argpars.is_used("kinds"))
+        {
+            kinds = argpars.get<std::vector<std::string>>("kinds");
+        }
+        std::cout << report(kinds, argpars["--long"] == true);
+    }
+}
@@ -0,0 +1,43 @@
+/************************************************************************************
+ * Copyright (c) 2025, xeus-cpp contributors                                        *
+ *                                                                                  *
+ * Distributed under the terms of the BSD 3-Clause License.                         *
+ *                                                                                  *
+ * The full license is in the file LICENSE, distributed with this software.         *
+ ************************************************************************************/
+
+#ifndef XEUS_CPP_WHO_MAGIC_HPP
+#define XEUS_CPP_WHO_MAGIC_HPP
+
+#include <string>
+#include <vector>
+
+#include "xeus-cpp/xmagics.hpp"
+#include "xeus-cpp/xoptions.hpp"
+
+namespace xcpp
+{
+    class xsymbol_index;
+
+    class who : public xmagic_line
+    {
+    public:
+
+        XEUS_CPP_API
+        explicit who(const xsymbol_index& index);
+
+        // %who [-l] [kind...]
+        XEUS_CPP_API
+        void operator()(const std::string& line) override;
+
+        // Names declared by the cells, or a table of their declarations
+        // when `long_format` is set, restricted to the given kinds if any.
+        XEUS_CPP_API
+        std::string report(const std::vector<std::string>& kinds, bool long_format) const;
+
+    private:
+
+        const xsymbol_index& m_index;
+    };
+}
+#endif
@@ -0,0 +1,243 @@
+/************************************************************************************
+ * Copyright (c) 2025, xeus-cpp contributors                                        *
+ *                                                                                  *
+ * Distributed under the terms of the BSD 3-Clause License.                         *
+ *                                                                                  *
+ * The full license is in the file LICENSE, distributed with this software.         *
+ ************************************************************************************/
+
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <CppInterOp/CppInterOp.h>
+
+#include "xcompiler.hpp"
+#include "xoptimizer.hpp"
+#include "xparser.hpp"
+
+namespace fs = std::filesystem;
+
+namespace xcpp
+{
+    namespace
+    {
+#if defined(_WIN32)
+        constexpr const char* library_extension = ".dll";
+#elif defined(__APPLE__)
+        constexpr const char* library_extension = ".dylib";
+#else
+        constexpr const char* library_extension = ".so";
+#endif
+
+        std::string join(const std::vector<std::string>& words, const std::string& separator)
+        {
+            std::string res;
+            for (const std::string& word : words)
+            {
+                res += (res.empty() ? "" : separator) + word;
+            }
+            return res;
+        }
+    }
+
+    xoptimizer::xoptimizer(
+        const std::vector<std::string>& interpreter_args,
+        const std::vector<std::string>& declarations
+    )
+        : m_interpreter_args(interpreter_args)
+        , m_declarations(declarations)
+        , m_execution_count(0)
+        , m_library_count(0)
+    {
+    }
+
+    xoptimizer::~xoptimizer()
+    {
+        // Loaded libraries are still mapped where they can be unlinked, the
+        // removal fails harmlessly elsewhere.
+        if (!m_directory.empty())
+        {
+            std::error_code ec;
+            fs::remove_all(m_directory, ec);
+        }
+    }
+
+    const std::vector<std::string>& xoptimizer::flags() const
+    {
+        return m_flags;
+    }
+
+    void xoptimizer::set_flags(const std::vector<std::string>& flags)
+    {
+        m_flags = flags;
+    }
+
+    bool xoptimizer::active() const
+    {
+        return !m_flags.empty();
+    }
+
+    bool xoptimizer::offload(
+        const std::string& code,
+        const std::vector<std::string>& flags,
+        std::string& jit_code,
+        std::string& pipeline,
+        std::string& diagnostics
+    )
+    {
+        // Types, templates and inline functions of the previous cells are
+        // shared with the library. Their other functions are only declared,
+        // so that those of previous libraries can be called, and their
+        // variables stay in the interpreter: the library cannot refer to
+        // symbols of the JIT.
+        std::ostringstream library_source;
+        std::string prototype;
+        std::string name;
+        for (const std::string& declaration : m_declarations)
+        {
+            const chunk_kind kind = classify_chunk(declaration);
+            if (function_prototype(declaration, prototype, name))
+            {
+                library_source << prototype << "\n";
+            }
+            else if (kind == chunk_kind::preprocessor || kind == chunk_kind::definition)
+            {
+                library_source << declaration << "\n";
+            }
+        }
+
+        std::ostringstream interpreter_source;
+        std::vector<std::string> functions;
+        for (const code_chunk& chunk : split_code(code))
+        {
+            if (function_prototype(chunk.code, prototype, name))
+            {
+                library_source << chunk.code << "\n";
+                interpreter_source << prototype << "\n";
+                functions.push_back(name);
+            }
+            else if (chunk.kind == chunk_kind::preprocessor || chunk.kind == chunk_kind::definition)
+            {
+                library_source << chunk.code << "\n";
+                interpreter_source << chunk.code << "\n";
+            }
+            else
+            {
+                interpreter_source << chunk.code << "\n";
+            }
+        }
+
+        if (functions.empty())
+        {
+            jit_code = code;
+            pipeline = jit_pipeline() + ", no function definition to compile ahead of time";
+            return true;
+        }
+
+        const std::string compiler = find_host_compiler();
+        if (compiler.empty())
+        {
+            diagnostics = "No C++ compiler found, set CXX or add clang++ to PATH\n";
+            return false;
+        }
+
+        if (m_directory.empty())
+        {
+            m_directory = make_private_directory("xcpp_opt_");
+            if (m_directory.empty())
+            {
+                diagnostics = "Could not create a temporary directory for the compiled functions\n";
+                return false;
+            }
+        }
+        std::error_code ec;
+        const std::string stem = (fs::path(m_directory) / ("cell_" + std::to_string(m_library_count++))).string();
+        const std::string source_path = stem + ".cpp";
+        const std::string library_path = stem + library_extension;
+        {
+            std::ofstream source(source_path);
+            source << library_source.str();
+            if (!source)
+            {
+                diagnostics = "Could not write " + source_path + "\n";
+                return false;
+            }
+        }
+
+        std::vector<std::string> args = {compiler};
+        std::vector<std::string> interpreter_flags = host_compiler_flags(m_interpreter_args);
+        args.insert(args.end(), interpreter_flags.begin(), interpreter_flags.end());
+        args.insert(args.end(), flags.begin(), flags.end());
+        args.push_back("-shared");
+#if !defined(_WIN32)
+        args.push_back("-fPIC");
+#endif
+#if defined(__linux__)
+        // Report references to interpreter symbols when linking rather than
+        // when the functions are called.
+        args.push_back("-Wl,-z,defs");
+#endif
+        args.insert(args.end(), {"-x", "c++", source_path, "-x", "none"});
+        args.insert(args.end(), m_libraries.begin(), m_libraries.end());
+        args.insert(args.end(), {"-o", library_path});
+
+        std::string output;
+        if (run_program(args, output) != 0)
+        {
+            diagnostics = output
+                          + "Functions compiled ahead of time can only use the types, templates and inline "
+                            "functions declared in previous cells.\n";
+            return false;
+        }
+        fs::remove(source_path, ec);
+
+        if (!Cpp::LoadLibrary(library_path.c_str(), false))
+        {
+            diagnostics = "Could not load " + library_path + "\n";
+            return false;
+        }
+        m_libraries.push_back(library_path);
+
+        jit_code = interpreter_source.str();
+        pipeline = fs::path(compiler).filename().string() + " " + join(flags, " ")
+                   + " with the full optimization pipeline for " + join(functions, ", ") + "; "
+                   + jit_pipeline() + " for the rest";
+        return true;
+    }
+
+    std::string xoptimizer::jit_pipeline() const
+    {
+        std::string level = "-O0";
+        for (const std::string& arg : m_interpreter_args)
+        {
+            if (arg.compare(0, 2, "-O") == 0)
+            {
+                level = arg;
+            }
+        }
+        return "interpreter JIT (IR emitted at " + level + ", no IR optimization pipeline)";
+    }
+
+    void xoptimizer::start_cell(int execution_count)
+    {
+        m_execution_count = execution_count;
+    }
+
+    void xoptimizer::record(const std::string& pipeline)
+    {
+        m_records.emplace_back(m_execution_count, pipeline);
+        if (m_records.size() > max_records)
+        {
+            m_records.pop_front();
+        }
+    }
+
+    const std::deque<xoptimizer::record_type>& xoptimizer::records() const
+    {
+        return m_records;
+    }
+}
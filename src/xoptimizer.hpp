@@ -0,0 +1,91 @@
+/************************************************************************************
+ * Copyright (c) 2025, xeus-cpp contributors                                        *
+ *                                                                                  *
+ * Distributed under the terms of the BSD 3-Clause License.                         *
+ *                                                                                  *
+ * The full license is in the file LICENSE, distributed with this software.         *
+ ************************************************************************************/
+
+#ifndef XEUS_CPP_OPTIMIZER_HPP
+#define XEUS_CPP_OPTIMIZER_HPP
+
+#include <cstddef>
+#include <deque>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "xeus-cpp/xeus_cpp_config.hpp"
+
+namespace xcpp
+{
+    /***************
+     * xoptimizer *
+     ***************/
+
+    // The interpreter emits IR for each cell and hands it to the JIT without
+    // running the LLVM optimization pipeline, whatever the -O level. Code
+    // that must be optimized is instead compiled ahead of time by the host
+    // compiler into a shared library loaded in the interpreter, and only the
+    // prototypes of its functions are given to the interpreter.
+    class XEUS_CPP_API xoptimizer
+    {
+    public:
+
+        using record_type = std::pair<int, std::string>;
+
+        xoptimizer(const std::vector<std::string>& interpreter_args, const std::vector<std::string>& declarations);
+        // Removes the libraries built.
+        ~xoptimizer();
+
+        xoptimizer(const xoptimizer&) = delete;
+        xoptimizer& operator=(const xoptimizer&) = delete;
+        xoptimizer(xoptimizer&&) = delete;
+        xoptimizer& operator=(xoptimizer&&) = delete;
+
+        // Session flags, set by %opt. When not empty, the function
+        // definitions of every cell are compiled with them.
+        const std::vector<std::string>& flags() const;
+        void set_flags(const std::vector<std::string>& flags);
+        bool active() const;
+
+        // Compiles the free function definitions of `code` with `flags` and
+        // loads them. `jit_code` receives the code left to the interpreter,
+        // where these definitions are replaced by their prototypes, and
+        // `pipeline` a description of how the cell is compiled. Returns false
+        // with the compiler output in `diagnostics` on failure.
+        bool offload(
+            const std::string& code,
+            const std::vector<std::string>& flags,
+            std::string& jit_code,
+            std::string& pipeline,
+            std::string& diagnostics
+        );
+
+        // Describes how the interpreter compiles cells on its own.
+        std::string jit_pipeline() const;
+
+        // Keeps how the cells were compiled, for the last `max_records` ones.
+        void start_cell(int execution_count);
+        void record(const std::string& pipeline);
+        const std::deque<record_type>& records() const;
+
+        static constexpr std::size_t max_records = 20;
+
+    private:
+
+        const std::vector<std::string>& m_interpreter_args;
+        const std::vector<std::string>& m_declarations;
+        std::vector<std::string> m_flags;
+        std::deque<record_type> m_records;
+        // Private directory of the libraries, created by the first one so
+        // that kernels forked from a warm interpreter each have their own.
+        std::string m_directory;
+        // Libraries built so far, linked into the next ones.
+        std::vector<std::string> m_libraries;
+        int m_execution_count;
+        std::size_t m_library_count;
+    };
+}
+
+#endif
@@ -0,0 +1,353 @@
+/************************************************************************************
+ * Copyright (c) 2025, xeus-cpp contributors                                        *
+ *                                                                                  *
+ * Distributed under the terms of the BSD 3-Clause License.                         *
+ *                                                                                  *
+ * The full license is in the file LICENSE, distributed with this software.         *
+ ************************************************************************************/
+
+#include <algorithm>
+#include <filesystem>
+#include <iomanip>
+#include <iterator>
+#include <sstream>
+#include <system_error>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "xeus-cpp/xutils.hpp"
+
+#include "xlive_output.hpp"
+#include "xoutput_limiter.hpp"
+
+#if defined(_WIN32)
+#include <process.h>
+#else
+#include <cerrno>
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace fs = std::filesystem;
+
+namespace xcpp
+{
+    namespace
+    {
+        std::string format_size(std::size_t size)
+        {
+            static const char* units[] = {"B", "KB", "MB", "GB"};
+            double value = static_cast<double>(size);
+            std::size_t unit = 0;
+            while (value >= 1024. && unit + 1 < std::size(units))
+            {
+                value /= 1024.;
+                ++unit;
+            }
+            std::ostringstream oss;
+            oss << std::setprecision(unit == 0 ? 0 : 1) << std::fixed << value << " " << units[unit];
+            return oss.str();
+        }
+
+        int process_id()
+        {
+#if defined(_WIN32)
+            return _getpid();
+#else
+            return getpid();
+#endif
+        }
+
+        // The spill files are created by name in `directory`, which must
+        // belong to the user and be closed to the others.
+        bool make_private(const fs::path& directory)
+        {
+            std::error_code ec;
+            fs::create_directories(directory, ec);
+#if !defined(_WIN32)
+            struct stat info;
+            if (::lstat(directory.c_str(), &info) != 0 || !S_ISDIR(info.st_mode) || info.st_uid != ::geteuid())
+            {
+                return false;
+            }
+            if ((info.st_mode & (S_IRWXG | S_IRWXO)) != 0 && ::chmod(directory.c_str(), S_IRWXU) != 0)
+            {
+                return false;
+            }
+#endif
+            return fs::is_directory(directory, ec);
+        }
+
+        // Removes the oldest files of `directory` until the others take at
+        // most `room` bytes. The files of running kernels may be removed
+        // too, they keep writing to it until the end of their cell.
+        void remove_old_spills(const fs::path& directory, std::uintmax_t room)
+        {
+            std::vector<std::pair<fs::file_time_type, fs::directory_entry>> found;
+            std::uintmax_t size = 0;
+            std::error_code ec;
+            for (const auto& dir_entry : fs::directory_iterator(directory, ec))
+            {
+                const std::string name = dir_entry.path().filename().string();
+                if (name.rfind("output-", 0) != 0 || dir_entry.path().extension() != ".log")
+                {
+                    continue;
+                }
+                std::error_code time_ec;
+                std::error_code size_ec;
+                auto time = dir_entry.last_write_time(time_ec);
+                std::uintmax_t file_size = dir_entry.file_size(size_ec);
+                if (!time_ec && !size_ec)
+                {
+                    found.emplace_back(time, dir_entry);
+                    size += file_size;
+                }
+            }
+
+            std::sort(
+                found.begin(),
+                found.end(),
+                [](const auto& lhs, const auto& rhs)
+                {
+                    return lhs.first < rhs.first;
+                }
+            );
+
+            for (const auto& [time, dir_entry] : found)
+            {
+                if (size <= room)
+                {
+                    break;
+                }
+                std::error_code size_ec;
+                std::uintmax_t file_size = dir_entry.file_size(size_ec);
+                std::error_code remove_ec;
+                if (!size_ec && fs::remove(dir_entry.path(), remove_ec))
+                {
+                    size -= std::min(file_size, size);
+                }
+            }
+        }
+
+        // Creates the file, failing if anything exists at `path`.
+        bool create_exclusive(const fs::path& path)
+        {
+#if defined(_WIN32)
+            std::error_code ec;
+            return !fs::exists(fs::symlink_status(path, ec));
+#else
+            int fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_EXCL | O_NOFOLLOW, S_IRUSR | S_IWUSR);
+            if (fd < 0)
+            {
+                return false;
+            }
+            ::close(fd);
+            return true;
+#endif
+        }
+    }
+
+    xoutput_limiter::xoutput_limiter(std::string name, callback_type callback)
+        : m_name(std::move(name))
+        , m_callback(std::move(callback))
+        , m_budget(0)
+        , m_total(0)
+        , m_spill_limit(0)
+        , m_spill_size(0)
+        , m_spill_cut(false)
+    {
+    }
+
+    void xoutput_limiter::set_budget(std::size_t budget)
+    {
+        m_budget = budget;
+    }
+
+    std::size_t xoutput_limiter::budget() const
+    {
+        return m_budget;
+    }
+
+    void xoutput_limiter::set_spill_limit(std::uintmax_t limit)
+    {
+        m_spill_limit = limit;
+    }
+
+    std::uintmax_t xoutput_limiter::spill_limit() const
+    {
+        return m_spill_limit;
+    }
+
+    void xoutput_limiter::start()
+    {
+        if (m_spill.is_open())
+        {
+            m_spill.close();
+        }
+        m_total = 0;
+        m_spill_size = 0;
+        m_spill_cut = false;
+        m_head.clear();
+        m_tail.clear();
+        m_spill_path.clear();
+    }
+
+    void xoutput_limiter::write(const std::string& data)
+    {
+        if (data.empty())
+        {
+            return;
+        }
+        const std::size_t before = m_total;
+        m_total += data.size();
+        if (m_budget == 0)
+        {
+            m_callback(data);
+            return;
+        }
+        // Bytes of `data` forwarded as is.
+        std::size_t shown_size = 0;
+        if (before > m_budget)
+        {
+            write_spill(data.data(), data.size());
+        }
+        else if (m_total <= m_budget)
+        {
+            m_head += data;
+            m_callback(data);
+            return;
+        }
+        else
+        {
+            std::string shown = data.substr(0, m_budget - before);
+            shown.resize(xlive_output::complete_utf8_prefix(shown));
+            if (!shown.empty())
+            {
+                m_callback(shown);
+            }
+            shown_size = shown.size();
+            open_spill();
+            write_spill(m_head.data(), m_head.size());
+            write_spill(data.data(), data.size());
+            std::string().swap(m_head);
+            m_callback(
+                "\n[Output exceeds " + format_size(m_budget) + ", "
+                + (m_spill ? "the rest is written to " + m_spill_path : std::string("the rest is discarded"))
+                + "]\n"
+            );
+        }
+
+        // Keeps at least the last tail_size() bytes, with a bounded slack.
+        const std::size_t keep = tail_size();
+        const std::size_t size = data.size() - shown_size;
+        if (size >= keep)
+        {
+            m_tail.assign(data, data.size() - keep, keep);
+        }
+        else
+        {
+            m_tail.append(data, shown_size, size);
+            if (m_tail.size() > 2 * keep)
+            {
+                m_tail.erase(0, m_tail.size() - keep);
+            }
+        }
+    }
+
+    void xoutput_limiter::finish()
+    {
+        if (m_budget != 0 && m_total > m_budget)
+        {
+            m_spill.close();
+            std::string tail = m_tail.size() > tail_size() ? m_tail.substr(m_tail.size() - tail_size()) : m_tail;
+            // Do not start in the middle of a UTF-8 sequence.
+            std::size_t start = 0;
+            while (start < tail.size() && (static_cast<unsigned char>(tail[start]) & 0xC0) == 0x80)
+            {
+                ++start;
+            }
+            tail.erase(0, start);
+            std::string file;
+            if (!m_spill_path.empty())
+            {
+                file = (m_spill_cut ? ", first " + format_size(m_spill_size) : std::string(", full output"))
+                       + " in " + m_spill_path;
+            }
+            m_callback(
+                "\n[" + format_size(m_total) + " written, showing the last " + format_size(tail.size()) + file
+                + "]\n" + tail
+            );
+        }
+        m_total = 0;
+        std::string().swap(m_head);
+        std::string().swap(m_tail);
+    }
+
+    std::size_t xoutput_limiter::total() const
+    {
+        return m_total;
+    }
+
+    const std::string& xoutput_limiter::spill_path() const
+    {
+        return m_spill_path;
+    }
+
+    void xoutput_limiter::open_spill()
+    {
+        static std::size_t count = 0;
+        m_spill_path.clear();
+        const std::string cache_dir = retrieve_cache_dir();
+        const fs::path directory = fs::path(cache_dir) / "output";
+        if (cache_dir.empty() || !make_private(directory))
+        {
+            return;
+        }
+        if (m_spill_limit != 0)
+        {
+            remove_old_spills(directory, m_spill_limit / 2);
+        }
+        // A file left by an earlier kernel with the same pid is kept.
+        for (int attempt = 0; attempt < 100; ++attempt)
+        {
+            fs::path path = directory
+                            / ("output-" + std::to_string(process_id()) + "-" + std::to_string(++count) + "-"
+                               + m_name + ".log");
+            if (!create_exclusive(path))
+            {
+#if !defined(_WIN32)
+                if (errno != EEXIST)
+                {
+                    return;
+                }
+#endif
+                continue;
+            }
+            // Written with plain writes rather than mapped: mapped pages of
+            // the file would count in the memory of the kernel until written
+            // back.
+            m_spill.open(path, std::ios::binary);
+            m_spill_path = m_spill ? path.string() : std::string();
+            return;
+        }
+    }
+
+    void xoutput_limiter::write_spill(const char* data, std::size_t size)
+    {
+        if (m_spill_limit != 0 && m_spill_size + size > m_spill_limit / 2)
+        {
+            m_spill_cut = true;
+            size = static_cast<std::size_t>(m_spill_limit / 2 - std::min(m_spill_size, m_spill_limit / 2));
+        }
+        m_spill.write(data, static_cast<std::streamsize>(size));
+        m_spill_size += size;
+    }
+
+    std::size_t xoutput_limiter::tail_size() const
+    {
+        return std::max<std::size_t>(m_budget / 8, 1);
+    }
+}
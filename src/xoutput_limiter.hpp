@@ -0,0 +1,82 @@
+/************************************************************************************
+ * Copyright (c) 2025, xeus-cpp contributors                                        *
+ *                                                                                  *
+ * Distributed under the terms of the BSD 3-Clause License.                         *
+ *                                                                                  *
+ * The full license is in the file LICENSE, distributed with this software.         *
+ ************************************************************************************/
+
+#ifndef XEUS_CPP_OUTPUT_LIMITER_HPP
+#define XEUS_CPP_OUTPUT_LIMITER_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <functional>
+#include <string>
+
+#include "xeus-cpp/xeus_cpp_config.hpp"
+
+namespace xcpp
+{
+    /*******************
+     * xoutput_limiter *
+     *******************/
+
+    // Caps the output of a stream published during a cell. The first
+    // `budget` bytes are forwarded to the callback; past the budget, the
+    // whole output of the cell is written to a file and only its last bytes
+    // are kept in memory, to be forwarded with the path of the file when the
+    // cell completes. The memory used is bounded by the budget whatever the
+    // size of the output. The files of all the kernels share a directory
+    // whose size is capped by the spill limit: the oldest files are removed
+    // to make room for a new one, and a file is cut at half the limit.
+    class XEUS_CPP_API xoutput_limiter
+    {
+    public:
+
+        using callback_type = std::function<void(const std::string&)>;
+
+        xoutput_limiter(std::string name, callback_type callback);
+
+        // 0 disables the limit.
+        void set_budget(std::size_t budget);
+        std::size_t budget() const;
+
+        // Size cap of the directory of the files, 0 disables it.
+        void set_spill_limit(std::uintmax_t limit);
+        std::uintmax_t spill_limit() const;
+
+        void start();
+        void write(const std::string& data);
+        void finish();
+
+        // Bytes written since the start of the cell.
+        std::size_t total() const;
+        // Path of the file holding the output of the cell, empty if it did
+        // not exceed the budget.
+        const std::string& spill_path() const;
+
+    private:
+
+        void open_spill();
+        void write_spill(const char* data, std::size_t size);
+        std::size_t tail_size() const;
+
+        std::string m_name;
+        callback_type m_callback;
+        std::size_t m_budget;
+        std::size_t m_total;
+        std::uintmax_t m_spill_limit;
+        // Bytes written to the file, which is cut at half the spill limit.
+        std::uintmax_t m_spill_size;
+        bool m_spill_cut;
+        // Output forwarded so far, kept to start the file with it.
+        std::string m_head;
+        std::string m_tail;
+        std::string m_spill_path;
+        std::ofstream m_spill;
+    };
+}
+
+#endif
@@ -9,6 +9,8 @@
 
 #include "xparser.hpp"
 
+#include <algorithm>
+#include <cctype>
 #include <cstddef>
 #include <regex>
 #include <sstream>
@@ -54,4 +56,421 @@ namespace xcpp
 
         return result;
     }
+
+    namespace
+    {
+        bool is_identifier_char(char c)
+        {
+            return std::isalnum(static_cast<unsigned char>(c)) || c == '_';
+        }
+
+        bool is_blank(const std::string& str)
+        {
+            return std::all_of(
+                str.begin(),
+                str.end(),
+                [](char c)
+                {
+                    return std::isspace(static_cast<unsigned char>(c));
+                }
+            );
+        }
+
+        bool is_comment(const std::string& code, std::size_t i)
+        {
+            return code[i] == '/' && i + 1 < code.size() && (code[i + 1] == '/' || code[i + 1] == '*');
+        }
+
+        // Returns the index past the comment or literal starting at `i`, or
+        // `i` if there is none.
+        std::size_t skip_literal(const std::string& code, std::size_t i)
+        {
+            const std::size_t size = code.size();
+            const char c = code[i];
+            if (is_comment(code, i))
+            {
+                std::size_t end = code[i + 1] == '/' ? code.find('\n', i) : code.find("*/", i + 2);
+                if (end == std::string::npos)
+                {
+                    return size;
+                }
+                return code[i + 1] == '/' ? end : end + 2;
+            }
+
+            // Start of the token `c` belongs to, to tell prefixes and digit
+            // separators from literals.
+            std::size_t token = i;
+            while (token > 0 && is_identifier_char(code[token - 1]))
+            {
+                --token;
+            }
+            const std::string prefix = code.substr(token, i - token);
+
+            if (c == 'R' && i + 1 < size && code[i + 1] == '"')
+            {
+                if (prefix != "" && prefix != "u8" && prefix != "u" && prefix != "U" && prefix != "L")
+                {
+                    return i;
+                }
+                std::size_t open = code.find('(', i + 2);
+                if (open == std::string::npos)
+                {
+                    return size;
+                }
+                std::string close = ")" + code.substr(i + 2, open - i - 2) + "\"";
+                std::size_t end = code.find(close, open + 1);
+                return end == std::string::npos ? size : end + close.size();
+            }
+
+            if (c == '"' || (c == '\'' && (prefix.empty() || !std::isdigit(static_cast<unsigned char>(prefix[0])))))
+            {
+                std::size_t j = i + 1;
+                while (j < size)
+                {
+                    if (code[j] == '\\')
+                    {
+                        j += 2;
+                    }
+                    else if (code[j] == c)
+                    {
+                        return j + 1;
+                    }
+                    else if (code[j] == '\n')
+                    {
+                        return j;
+                    }
+                    else
+                    {
+                        ++j;
+                    }
+                }
+                return size;
+            }
+            return i;
+        }
+
+        std::string strip_comments(const std::string& code)
+        {
+            std::string res;
+            std::size_t i = 0;
+            while (i < code.size())
+            {
+                std::size_t next = skip_literal(code, i);
+                if (next == i)
+                {
+                    res += code[i++];
+                    continue;
+                }
+                res += is_comment(code, i) ? std::string(" ") : code.substr(i, next - i);
+                i = next;
+            }
+            return res;
+        }
+
+        // Whether a block opened at namespace scope after `head` is part of a
+        // declaration that ends with a semicolon, like a class definition.
+        bool block_needs_semicolon(const std::string& head)
+        {
+            static const std::regex re_aggregate(
+                R"(^\s*(template\s*<[^{]*>\s*)?(typedef\s+)?(struct|class|union|enum)\b)"
+            );
+            return std::regex_search(strip_comments(head), re_aggregate);
+        }
+
+        // Position of the first character of `chars` outside of brackets,
+        // comments and literals.
+        std::size_t find_top_level(const std::string& code, const std::string& chars)
+        {
+            int depth = 0;
+            std::size_t i = 0;
+            while (i < code.size())
+            {
+                std::size_t next = skip_literal(code, i);
+                if (next != i)
+                {
+                    i = next;
+                    continue;
+                }
+                const char c = code[i];
+                if (depth == 0 && chars.find(c) != std::string::npos)
+                {
+                    if (c != '=' || (i + 1 < code.size() && code[i + 1] != '='))
+                    {
+                        return i;
+                    }
+                    ++i;
+                }
+                if (c == '(' || c == '[' || c == '{')
+                {
+                    ++depth;
+                }
+                else if ((c == ')' || c == ']' || c == '}') && depth > 0)
+                {
+                    --depth;
+                }
+                ++i;
+            }
+            return std::string::npos;
+        }
+
+        std::string first_word(const std::string& code)
+        {
+            std::size_t end = 0;
+            while (end < code.size() && is_identifier_char(code[end]))
+            {
+                ++end;
+            }
+            return code.substr(0, end);
+        }
+    }
+
+    std::vector<code_chunk> split_code(const std::string& code)
+    {
+        std::vector<code_chunk> res;
+        const std::size_t size = code.size();
+        std::size_t start = 0;
+        std::size_t i = 0;
+        int depth = 0;
+        bool has_code = false;
+        bool has_assignment = false;
+        bool needs_semicolon = false;
+
+        auto flush = [&](std::size_t end)
+        {
+            std::string chunk = code.substr(start, end - start);
+            if (!is_blank(chunk))
+            {
+                res.push_back({classify_chunk(chunk), chunk});
+            }
+            start = end;
+            has_code = false;
+            has_assignment = false;
+        };
+
+        while (i < size)
+        {
+            std::size_t next = skip_literal(code, i);
+            if (next != i)
+            {
+                has_code = has_code || !is_comment(code, i);
+                i = next;
+                continue;
+            }
+
+            const char c = code[i];
+            if (c == '#' && depth == 0 && !has_code)
+            {
+                // Directives end with the first newline that is not escaped.
+                std::size_t end = i;
+                while (end < size && (code[end] != '\n' || code[end - 1] == '\\'))
+                {
+                    ++end;
+                }
+                flush(end);
+                i = end;
+                continue;
+            }
+
+            if (c == '(' || c == '[' || c == '{')
+            {
+                if (c == '{' && depth == 0)
+                {
+                    needs_semicolon = has_assignment || block_needs_semicolon(code.substr(start, i - start));
+                }
+                ++depth;
+            }
+            else if ((c == ')' || c == ']') && depth > 0)
+            {
+                --depth;
+            }
+            else if (c == '}' && depth > 0)
+            {
+                --depth;
+                if (depth == 0 && !needs_semicolon)
+                {
+                    // Function and namespace bodies end the declaration, a
+                    // stray semicolon is kept with it.
+                    std::size_t end = code.find_first_not_of(" \t\r\n", i + 1);
+                    end = (end != std::string::npos && code[end] == ';') ? end + 1 : i + 1;
+                    flush(end);
+                    i = end;
+                    continue;
+                }
+            }
+            else if (c == ';' && depth == 0)
+            {
+                flush(i + 1);
+                ++i;
+                continue;
+            }
+            else if (c == '=' && depth == 0)
+            {
+                const bool comparison = (i + 1 < size && code[i + 1] == '=')
+                                        || (i > 0 && std::string("=!<>").find(code[i - 1]) != std::string::npos);
+                const bool is_operator = code.substr(start, i - start).find("operator") != std::string::npos;
+                has_assignment = has_assignment || (!comparison && !is_operator);
+            }
+
+            has_code = has_code || !std::isspace(static_cast<unsigned char>(c));
+            ++i;
+        }
+        flush(size);
+        return res;
+    }
+
+    std::vector<std::string> split_declarations(const std::string& code)
+    {
+        std::vector<std::string> res;
+        for (const code_chunk& chunk : split_code(code))
+        {
+            if (chunk.kind != chunk_kind::statement)
+            {
+                res.push_back(chunk.code);
+            }
+        }
+        return res;
+    }
+
+    chunk_kind classify_chunk(const std::string& chunk)
+    {
+        static const std::vector<std::string> definition_keywords = {
+            "template", "namespace", "struct", "class", "union", "enum", "extern",
+            "static_assert", "typedef", "using", "concept"
+        };
+        static const std::vector<std::string> statement_keywords = {
+            "if", "for", "while", "do", "switch", "return", "try", "throw", "break",
+            "continue", "goto", "delete", "new", "co_return", "co_await", "co_yield"
+        };
+        static const std::vector<std::string> type_keywords = {
+            "auto", "const", "constexpr", "constinit", "static", "thread_local", "inline",
+            "volatile", "unsigned", "signed", "short", "long", "int", "char", "char8_t",
+            "char16_t", "char32_t", "wchar_t", "bool", "float", "double", "void"
+        };
+        auto contains = [](const std::vector<std::string>& words, const std::string& word)
+        {
+            return std::find(words.begin(), words.end(), word) != words.end();
+        };
+
+        std::string code = strip_comments(chunk);
+        std::size_t first = code.find_first_not_of(" \t\r\n");
+        if (first == std::string::npos)
+        {
+            return chunk_kind::statement;
+        }
+        std::size_t last = code.find_last_not_of(" \t\r\n");
+        code = code.substr(first, last - first + 1);
+
+        if (code[0] == '#')
+        {
+            return chunk_kind::preprocessor;
+        }
+        if (code[0] == '{')
+        {
+            return chunk_kind::statement;
+        }
+
+        const std::string word = first_word(code);
+        if (contains(definition_keywords, word))
+        {
+            return chunk_kind::definition;
+        }
+        if (contains(statement_keywords, word))
+        {
+            return chunk_kind::statement;
+        }
+
+        // Only function definitions end with a body at namespace scope, the
+        // other braces belong to initializers.
+        std::size_t body = find_top_level(code, "{");
+        if (code.back() == '}' && body != std::string::npos
+            && code.substr(0, body).find(')') != std::string::npos)
+        {
+            return chunk_kind::definition;
+        }
+        if (contains(type_keywords, word))
+        {
+            return chunk_kind::variable;
+        }
+
+        // A declaration starts with a type followed by a name, an expression
+        // has operators between its names.
+        std::string head = code.substr(0, std::min(find_top_level(code, "=({;"), code.size()));
+        static const std::regex re_template_args(R"(<[^<>]*>)");
+        std::string previous;
+        while (previous != head)
+        {
+            previous = head;
+            head = std::regex_replace(head, re_template_args, " ");
+        }
+        static const std::regex re_declarator(R"(^[A-Za-z_][\w:\s*&\[\],]*$)");
+        if (!std::regex_match(head, re_declarator))
+        {
+            return chunk_kind::statement;
+        }
+        head = head.substr(0, head.find('['));
+        static const std::regex re_word(R"([\w:]+)");
+        auto words = std::distance(std::sregex_iterator(head.begin(), head.end(), re_word), std::sregex_iterator());
+        return words >= 2 ? chunk_kind::variable : chunk_kind::statement;
+    }
+
+    bool function_prototype(const std::string& chunk, std::string& prototype, std::string& name)
+    {
+        if (classify_chunk(chunk) != chunk_kind::definition)
+        {
+            return false;
+        }
+        const std::string code = strip_comments(chunk);
+        const std::size_t body = find_top_level(code, "{");
+        if (body == std::string::npos)
+        {
+            return false;
+        }
+        const std::string head = code.substr(0, body);
+        const std::size_t paren = find_top_level(head, "(");
+        if (paren == std::string::npos || paren == 0)
+        {
+            return false;
+        }
+
+        std::size_t end = head.find_last_not_of(" \t\r\n", paren - 1);
+        if (end == std::string::npos)
+        {
+            return false;
+        }
+        std::size_t begin = end + 1;
+        while (begin > 0 && (is_identifier_char(head[begin - 1]) || head[begin - 1] == ':'))
+        {
+            --begin;
+        }
+        const std::string candidate = head.substr(begin, end + 1 - begin);
+        // Members and operators cannot be redeclared on their own.
+        if (candidate.empty() || candidate.find("::") != std::string::npos
+            || candidate.compare(0, 8, "operator") == 0)
+        {
+            return false;
+        }
+
+        // These definitions must be visible to their callers.
+        static const std::regex re_excluded(
+            R"(\b(template|inline|static|constexpr|consteval|namespace|struct|class|union|enum|extern|typedef|using)\b)"
+        );
+        const std::string specifiers = head.substr(0, begin);
+        if (std::regex_search(specifiers, re_excluded))
+        {
+            return false;
+        }
+        // A deduced return type needs the body.
+        if (first_word(specifiers.substr(std::min(specifiers.find_first_not_of(" \t\r\n"), specifiers.size())))
+                == "auto"
+            && head.find("->", paren) == std::string::npos)
+        {
+            return false;
+        }
+
+        std::size_t first = head.find_first_not_of(" \t\r\n");
+        std::size_t last = head.find_last_not_of(" \t\r\n");
+        prototype = head.substr(first, last - first + 1) + ";";
+        name = candidate;
+        return true;
+    }
 }
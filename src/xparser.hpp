@@ -12,6 +12,7 @@
 
 #include "xeus-cpp/xeus_cpp_config.hpp"
 
+#include <cstddef>
 #include <string>
 #include <vector>
 
@@ -22,5 +23,43 @@ namespace xcpp
 
     XEUS_CPP_API std::vector<std::string>
     split_line(const std::string& input, const std::string& delims, std::size_t cursor_pos);
+
+    enum class chunk_kind
+    {
+        // A preprocessor directive.
+        preprocessor,
+        // A declaration that cannot appear in a function body: function,
+        // class, namespace, template...
+        definition,
+        // A declaration that may appear at namespace or block scope, such as
+        // a variable.
+        variable,
+        // Anything else.
+        statement
+    };
+
+    struct code_chunk
+    {
+        chunk_kind kind;
+        std::string code;
+    };
+
+    // Splits a cell into its top-level declarations and statements. This is
+    // a lexical approximation: it tracks brackets, comments and literals but
+    // does not parse C++.
+    XEUS_CPP_API
+    std::vector<code_chunk> split_code(const std::string& code);
+
+    XEUS_CPP_API
+    chunk_kind classify_chunk(const std::string& chunk);
+
+    // Returns the chunks of `code` that are not statements.
+    XEUS_CPP_API
+    std::vector<std::string> split_declarations(const std::string& code);
+
+    // If `chunk` is the definition of a non-inline, non-template free
+    // function, sets `prototype` to its declaration and `name` to its name.
+    XEUS_CPP_API
+    bool function_prototype(const std::string& chunk, std::string& prototype, std::string& name);
 }
 #endif
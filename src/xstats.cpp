@@ -0,0 +1,248 @@
+/************************************************************************************
+ * Copyright (c) 2025, xeus-cpp contributors                                        *
+ *                                                                                  *
+ * Distributed under the terms of the BSD 3-Clause License.                         *
+ *                                                                                  *
+ * The full license is in the file LICENSE, distributed with this software.         *
+ ************************************************************************************/
+
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+#include <sstream>
+#include <string>
+
+#include "xstats.hpp"
+
+namespace xcpp
+{
+    namespace
+    {
+        // Values below 2 * sub_bucket_count are counted exactly.
+        constexpr std::size_t sub_bucket_bits = 5;
+        constexpr std::size_t sub_bucket_count = std::size_t(1) << sub_bucket_bits;
+
+        std::size_t most_significant_bit(std::uint64_t value)
+        {
+            std::size_t res = 0;
+            while (value >>= 1)
+            {
+                ++res;
+            }
+            return res;
+        }
+
+        std::string format_ms(double ns)
+        {
+            std::ostringstream oss;
+            oss << std::fixed << std::setprecision(3) << ns / 1e6;
+            return oss.str();
+        }
+    }
+
+    /*****************************
+     * xhistogram implementation *
+     *****************************/
+
+    std::size_t xhistogram::bucket_index(std::uint64_t value)
+    {
+        if (value < 2 * sub_bucket_count)
+        {
+            return static_cast<std::size_t>(value);
+        }
+        const std::size_t shift = most_significant_bit(value) - sub_bucket_bits;
+        return sub_bucket_count * shift + static_cast<std::size_t>(value >> shift);
+    }
+
+    std::uint64_t xhistogram::bucket_upper_bound(std::size_t index)
+    {
+        if (index < 2 * sub_bucket_count)
+        {
+            return index;
+        }
+        const std::size_t shift = index / sub_bucket_count - 1;
+        const std::uint64_t sub_bucket = index - sub_bucket_count * shift;
+        // Wraps around to the largest value for the last bucket.
+        return ((sub_bucket + 1) << shift) - 1;
+    }
+
+    void xhistogram::record(std::uint64_t value)
+    {
+        const std::size_t index = bucket_index(value);
+        if (index >= m_buckets.size())
+        {
+            m_buckets.resize(index + 1, 0);
+        }
+        ++m_buckets[index];
+        m_min = m_count == 0 ? value : std::min(m_min, value);
+        m_max = std::max(m_max, value);
+        m_total += static_cast<double>(value);
+        ++m_count;
+    }
+
+    void xhistogram::reset()
+    {
+        *this = xhistogram();
+    }
+
+    std::uint64_t xhistogram::count() const
+    {
+        return m_count;
+    }
+
+    std::uint64_t xhistogram::min() const
+    {
+        return m_min;
+    }
+
+    std::uint64_t xhistogram::max() const
+    {
+        return m_max;
+    }
+
+    double xhistogram::mean() const
+    {
+        return m_count == 0 ? 0. : m_total / static_cast<double>(m_count);
+    }
+
+    std::uint64_t xhistogram::value_at_percentile(double percentile) const
+    {
+        if (m_count == 0)
+        {
+            return 0;
+        }
+        percentile = std::clamp(percentile, 0., 100.);
+        const auto target = std::max<std::uint64_t>(
+            1,
+            static_cast<std::uint64_t>(std::ceil(percentile / 100. * static_cast<double>(m_count)))
+        );
+        std::uint64_t seen = 0;
+        for (std::size_t i = 0; i < m_buckets.size(); ++i)
+        {
+            seen += m_buckets[i];
+            if (seen >= target)
+            {
+                return std::clamp(bucket_upper_bound(i), m_min, m_max);
+            }
+        }
+        return m_max;
+    }
+
+    nl::json xhistogram::to_json() const
+    {
+        return {
+            {"count", m_count},
+            {"min", m_min},
+            {"max", m_max},
+            {"mean", mean()},
+            {"p50", value_at_percentile(50.)},
+            {"p90", value_at_percentile(90.)},
+            {"p99", value_at_percentile(99.)},
+            {"p999", value_at_percentile(99.9)}
+        };
+    }
+
+    /*************************
+     * xstats implementation *
+     *************************/
+
+    void xstats::record(std::string_view request, std::string_view phase, clock::duration duration)
+    {
+        auto request_it = m_requests.find(request);
+        if (request_it == m_requests.end())
+        {
+            request_it = m_requests.emplace(std::string(request), phase_map()).first;
+        }
+        auto phase_it = request_it->second.find(phase);
+        if (phase_it == request_it->second.end())
+        {
+            phase_it = request_it->second.emplace(std::string(phase), xhistogram()).first;
+        }
+        const auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(duration).count();
+        phase_it->second.record(static_cast<std::uint64_t>(std::max<decltype(ns)>(ns, 0)));
+    }
+
+    void xstats::reset()
+    {
+        m_requests.clear();
+    }
+
+    const xhistogram* xstats::find(std::string_view request, std::string_view phase) const
+    {
+        auto request_it = m_requests.find(request);
+        if (request_it == m_requests.end())
+        {
+            return nullptr;
+        }
+        auto phase_it = request_it->second.find(phase);
+        return phase_it == request_it->second.end() ? nullptr : &phase_it->second;
+    }
+
+    nl::json xstats::to_json() const
+    {
+        nl::json requests = nl::json::object();
+        for (const auto& [request, phases] : m_requests)
+        {
+            nl::json& entry = requests[request];
+            for (const auto& [phase, histogram] : phases)
+            {
+                entry[phase] = histogram.to_json();
+            }
+        }
+        return {{"unit", "ns"}, {"requests", requests}};
+    }
+
+    std::string xstats::report() const
+    {
+        std::ostringstream oss;
+        oss << std::left << std::setw(24) << "phase (ms)" << std::right << std::setw(8) << "count"
+            << std::setw(11) << "mean" << std::setw(11) << "p50" << std::setw(11) << "p90" << std::setw(11)
+            << "p99" << std::setw(11) << "max" << "\n";
+        for (const auto& [request, phases] : m_requests)
+        {
+            oss << request << "\n";
+            for (const auto& [phase, histogram] : phases)
+            {
+                oss << "  " << std::left << std::setw(22) << phase << std::right << std::setw(8)
+                    << histogram.count() << std::setw(11) << format_ms(histogram.mean()) << std::setw(11)
+                    << format_ms(static_cast<double>(histogram.value_at_percentile(50.))) << std::setw(11)
+                    << format_ms(static_cast<double>(histogram.value_at_percentile(90.))) << std::setw(11)
+                    << format_ms(static_cast<double>(histogram.value_at_percentile(99.))) << std::setw(11)
+                    << format_ms(static_cast<double>(histogram.max())) << "\n";
+            }
+        }
+        return oss.str();
+    }
+
+    /******************************
+     * phase_timer implementation *
+     ******************************/
+
+    phase_timer::phase_timer(xstats& stats, std::string_view request, std::string_view phase)
+        : m_stats(stats)
+        , m_request(request)
+        , m_phase(phase)
+        , m_start(xstats::clock::now())
+        , m_running(true)
+    {
+    }
+
+    phase_timer::~phase_timer()
+    {
+        if (m_running)
+        {
+            stop();
+        }
+    }
+
+    xstats::clock::duration phase_timer::stop()
+    {
+        const auto elapsed = xstats::clock::now() - m_start;
+        if (m_running)
+        {
+            m_stats.record(m_request, m_phase, elapsed);
+            m_running = false;
+        }
+        return elapsed;
+    }
+}
@@ -0,0 +1,124 @@
+/************************************************************************************
+ * Copyright (c) 2025, xeus-cpp contributors                                        *
+ *                                                                                  *
+ * Distributed under the terms of the BSD 3-Clause License.                         *
+ *                                                                                  *
+ * The full license is in the file LICENSE, distributed with this software.         *
+ ************************************************************************************/
+
+#ifndef XEUS_CPP_STATS_HPP
+#define XEUS_CPP_STATS_HPP
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <nlohmann/json.hpp>
+
+#include "xeus-cpp/xeus_cpp_config.hpp"
+
+namespace nl = nlohmann;
+
+namespace xcpp
+{
+    /***************
+     * xhistogram *
+     ***************/
+
+    // Log-linear histogram of durations in nanoseconds, in the spirit of
+    // HdrHistogram: values below 64 are counted exactly, above they fall in
+    // one of 32 buckets per power of two, which bounds the relative error of
+    // the reported values to about 3% with a constant cost per record.
+    class XEUS_CPP_API xhistogram
+    {
+    public:
+
+        void record(std::uint64_t value);
+        void reset();
+
+        std::uint64_t count() const;
+        std::uint64_t min() const;
+        std::uint64_t max() const;
+        double mean() const;
+
+        // Highest value equivalent to the value at `percentile`, in [0, 100].
+        std::uint64_t value_at_percentile(double percentile) const;
+
+        nl::json to_json() const;
+
+        static std::size_t bucket_index(std::uint64_t value);
+        static std::uint64_t bucket_upper_bound(std::size_t index);
+
+    private:
+
+        std::vector<std::uint64_t> m_buckets;
+        std::uint64_t m_count = 0;
+        std::uint64_t m_min = 0;
+        std::uint64_t m_max = 0;
+        double m_total = 0.;
+    };
+
+    /**********
+     * xstats *
+     **********/
+
+    // Durations of the phases of the requests handled by the kernel, one
+    // histogram per request type and phase. Requests are handled one at a
+    // time by the shell, so no synchronization is needed.
+    class XEUS_CPP_API xstats
+    {
+    public:
+
+        using clock = std::chrono::steady_clock;
+        using phase_map = std::map<std::string, xhistogram, std::less<>>;
+
+        void record(std::string_view request, std::string_view phase, clock::duration duration);
+        void reset();
+
+        // Histogram of a phase, nullptr if it was never recorded.
+        const xhistogram* find(std::string_view request, std::string_view phase) const;
+
+        nl::json to_json() const;
+
+        // Human readable table, durations in milliseconds.
+        std::string report() const;
+
+    private:
+
+        std::map<std::string, phase_map, std::less<>> m_requests;
+    };
+
+    /****************
+     * phase_timer *
+     ****************/
+
+    // Records the time elapsed since its construction when stopped or
+    // destroyed, whichever comes first.
+    class XEUS_CPP_API phase_timer
+    {
+    public:
+
+        phase_timer(xstats& stats, std::string_view request, std::string_view phase);
+        ~phase_timer();
+
+        phase_timer(const phase_timer&) = delete;
+        phase_timer& operator=(const phase_timer&) = delete;
+
+        xstats::clock::duration stop();
+
+    private:
+
+        xstats& m_stats;
+        std::string_view m_request;
+        std::string_view m_phase;
+        xstats::clock::time_point m_start;
+        bool m_running;
+    };
+}
+
+#endif
@@ -0,0 +1,452 @@
+/************************************************************************************
+ * Copyright (c) 2025, xeus-cpp contributors                                        *
+ *                                                                                  *
+ * Distributed under the terms of the BSD 3-Clause License.                         *
+ *                                                                                  *
+ * The full license is in the file LICENSE, distributed with this software.         *
+ ************************************************************************************/
+
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+#include <set>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <CppInterOp/CppInterOp.h>
+
+#include "xsymbol_index.hpp"
+
+namespace xcpp
+{
+    namespace
+    {
+        bool is_identifier_start(char c)
+        {
+            return std::isalpha(static_cast<unsigned char>(c)) || c == '_';
+        }
+
+        bool is_identifier_char(char c)
+        {
+            return std::isalnum(static_cast<unsigned char>(c)) || c == '_';
+        }
+
+        // Resolves `name`, qualified or not, from the global scope.
+        bool classify(const std::string& name, xsymbol& symbol)
+        {
+            Cpp::TCppScope_t parent = Cpp::GetGlobalScope();
+            std::size_t start = 0;
+            for (std::size_t end = name.find("::"); end != std::string::npos; end = name.find("::", start))
+            {
+                if (end != start)
+                {
+                    parent = Cpp::GetNamed(name.substr(start, end - start), parent);
+                    if (parent == nullptr)
+                    {
+                        return false;
+                    }
+                }
+                start = end + 2;
+            }
+            const std::string last = name.substr(start);
+            if (last.empty())
+            {
+                return false;
+            }
+
+            std::vector<Cpp::TCppFunction_t> functions = Cpp::GetFunctionsUsingName(parent, last);
+            if (!functions.empty())
+            {
+                symbol.kind = "function";
+                for (Cpp::TCppFunction_t function : functions)
+                {
+                    symbol.declarations.push_back(Cpp::GetFunctionSignature(function));
+                }
+                return true;
+            }
+
+            Cpp::TCppScope_t scope = Cpp::GetNamed(last, parent);
+            if (scope == nullptr)
+            {
+                return false;
+            }
+            if (Cpp::IsNamespace(scope))
+            {
+                symbol.kind = "namespace";
+            }
+            else if (Cpp::IsEnumScope(scope))
+            {
+                symbol.kind = "enum";
+                std::string declaration = "enum " + Cpp::GetQualifiedName(scope) + " {";
+                const std::vector<Cpp::TCppScope_t> constants = Cpp::GetEnumConstants(scope);
+                for (std::size_t i = 0; i < constants.size(); ++i)
+                {
+                    declaration += (i == 0 ? " " : ", ") + Cpp::GetName(constants[i]);
+                }
+                symbol.declarations.push_back(declaration + " }");
+            }
+            else if (Cpp::IsClass(scope))
+            {
+                symbol.kind = "class";
+                std::string declaration = "class " + Cpp::GetQualifiedName(scope);
+                const std::size_t bases = Cpp::GetNumBases(scope);
+                for (std::size_t i = 0; i < bases; ++i)
+                {
+                    declaration += (i == 0 ? " : " : ", ") + Cpp::GetQualifiedName(Cpp::GetBaseClass(scope, i));
+                }
+                symbol.declarations.push_back(declaration);
+            }
+            else if (Cpp::IsTemplate(scope))
+            {
+                symbol.kind = "template";
+            }
+            else if (Cpp::IsTypedefed(scope))
+            {
+                symbol.kind = "typedef";
+                symbol.declarations.push_back(
+                    "using " + last + " = "
+                    + Cpp::GetTypeAsString(Cpp::GetCanonicalType(Cpp::GetTypeFromScope(scope)))
+                );
+            }
+            else if (Cpp::IsVariable(scope))
+            {
+                symbol.kind = "variable";
+                symbol.declarations.push_back(Cpp::GetTypeAsString(Cpp::GetVariableType(scope)) + " " + last);
+            }
+            else
+            {
+                return false;
+            }
+            return true;
+        }
+
+        // Text of a comment without its markers.
+        std::string strip_comment(const std::string& text)
+        {
+            std::string res;
+            std::size_t start = 0;
+            while (start <= text.size())
+            {
+                std::size_t end = text.find('\n', start);
+                end = end == std::string::npos ? text.size() : end;
+                std::string line = text.substr(start, end - start);
+                start = end + 1;
+
+                for (const char* marker : {"///<", "//!<", "///", "//!", "//", "/**<", "/**", "/*!", "/*"})
+                {
+                    const std::size_t pos = line.find_first_not_of(" \t");
+                    if (pos != std::string::npos && line.compare(pos, std::strlen(marker), marker) == 0)
+                    {
+                        line.erase(0, pos + std::strlen(marker));
+                        break;
+                    }
+                }
+                const std::size_t close = line.rfind("*/");
+                if (close != std::string::npos)
+                {
+                    line.erase(close);
+                }
+                // Leading stars of the lines of a block comment.
+                const std::size_t first = line.find_first_not_of(" \t*");
+                if (first == std::string::npos)
+                {
+                    continue;
+                }
+                const std::size_t last = line.find_last_not_of(" \t");
+                res += (res.empty() ? "" : "\n") + line.substr(first, last - first + 1);
+            }
+            return res;
+        }
+    }
+
+    std::string summary(const xsymbol& symbol)
+    {
+        std::string res = symbol.kind + " " + symbol.name;
+        if (!symbol.declarations.empty())
+        {
+            res = symbol.kind;
+            for (const std::string& declaration : symbol.declarations)
+            {
+                res += "\n    " + declaration;
+            }
+        }
+        if (!symbol.comment.empty())
+        {
+            res += "\n\n" + symbol.comment;
+        }
+        if (symbol.execution_count != 0)
+        {
+            res += "\n\nDeclared in cell [" + std::to_string(symbol.execution_count) + "]";
+            if (symbol.line != 0)
+            {
+                res += ", line " + std::to_string(symbol.line);
+            }
+        }
+        return res;
+    }
+
+    std::string markdown_summary(const xsymbol& symbol)
+    {
+        std::string res;
+        if (!symbol.declarations.empty())
+        {
+            res += "```cpp\n";
+            for (const std::string& declaration : symbol.declarations)
+            {
+                res += declaration + "\n";
+            }
+            res += "```\n\n";
+        }
+        if (!symbol.comment.empty())
+        {
+            res += symbol.comment + "\n\n";
+        }
+        res += "*" + symbol.kind + "* `" + symbol.name + "`";
+        if (symbol.execution_count != 0)
+        {
+            res += ", declared in cell [" + std::to_string(symbol.execution_count) + "]";
+            if (symbol.line != 0)
+            {
+                res += ", line " + std::to_string(symbol.line);
+            }
+        }
+        return res + "\n";
+    }
+
+    void xsymbol_index::snapshot()
+    {
+        m_known.clear();
+        Cpp::GetAllCppNames(Cpp::GetGlobalScope(), m_known);
+    }
+
+    void xsymbol_index::update(const std::string& code, int execution_count)
+    {
+        m_described.clear();
+        std::set<std::string> names;
+        Cpp::GetAllCppNames(Cpp::GetGlobalScope(), names);
+        const std::set<std::string> used = identifiers(code);
+        for (const std::string& name : names)
+        {
+            // Indexed names are described again, a function may have gained
+            // overloads. They are only updated if their declarations changed,
+            // not when the cell merely uses them.
+            if ((m_known.count(name) == 0 || m_symbols.count(name) != 0) && used.count(name) != 0)
+            {
+                xsymbol symbol{name, "", {}, execution_count};
+                if (!classify(name, symbol))
+                {
+                    continue;
+                }
+                const xsymbol* indexed = find(name);
+                if (indexed == nullptr || indexed->kind != symbol.kind
+                    || indexed->declarations != symbol.declarations)
+                {
+                    symbol.comment = comment(code, name, symbol.line);
+                    insert(std::move(symbol));
+                }
+            }
+        }
+        m_known = std::move(names);
+    }
+
+    void xsymbol_index::insert(xsymbol symbol)
+    {
+        std::string name = symbol.name;
+        m_symbols.insert_or_assign(std::move(name), std::move(symbol));
+    }
+
+    const xsymbol* xsymbol_index::find(const std::string& name) const
+    {
+        auto it = m_symbols.find(name);
+        return it == m_symbols.end() ? nullptr : &it->second;
+    }
+
+    const xsymbol* xsymbol_index::describe(const std::string& name)
+    {
+        if (const xsymbol* symbol = find(name))
+        {
+            return symbol;
+        }
+        auto it = m_described.find(name);
+        if (it == m_described.end())
+        {
+            xsymbol symbol{name, "", {}, 0};
+            if (!classify(name, symbol))
+            {
+                symbol.kind.clear();
+            }
+            it = m_described.emplace(name, std::move(symbol)).first;
+        }
+        return it->second.kind.empty() ? nullptr : &it->second;
+    }
+
+    std::vector<const xsymbol*> xsymbol_index::complete(const std::string& prefix) const
+    {
+        std::vector<const xsymbol*> res;
+        for (auto it = m_symbols.lower_bound(prefix);
+             it != m_symbols.end() && it->first.compare(0, prefix.size(), prefix) == 0;
+             ++it)
+        {
+            res.push_back(&it->second);
+        }
+        return res;
+    }
+
+    const xsymbol_index::symbol_map& xsymbol_index::symbols() const
+    {
+        return m_symbols;
+    }
+
+    std::set<std::string> xsymbol_index::identifiers(const std::string& code)
+    {
+        std::set<std::string> res;
+        const std::size_t size = code.size();
+        std::size_t i = 0;
+        while (i < size)
+        {
+            const char c = code[i];
+            if (c == '/' && i + 1 < size && code[i + 1] == '/')
+            {
+                i = code.find('\n', i);
+                i = i == std::string::npos ? size : i;
+            }
+            else if (c == '/' && i + 1 < size && code[i + 1] == '*')
+            {
+                i = code.find("*/", i + 2);
+                i = i == std::string::npos ? size : i + 2;
+            }
+            else if (c == '"' || c == '\'')
+            {
+                ++i;
+                while (i < size && code[i] != c)
+                {
+                    i += code[i] == '\\' ? 2 : 1;
+                }
+                ++i;
+            }
+            else if (is_identifier_start(c))
+            {
+                const std::size_t start = i;
+                while (i < size && is_identifier_char(code[i]))
+                {
+                    ++i;
+                }
+                res.insert(code.substr(start, i - start));
+            }
+            else if (std::isdigit(static_cast<unsigned char>(c)))
+            {
+                // Skips numbers and their suffixes, such as 1.0f or 0x1Fu.
+                while (i < size && (is_identifier_char(code[i]) || code[i] == '.'))
+                {
+                    ++i;
+                }
+            }
+            else
+            {
+                ++i;
+            }
+        }
+        return res;
+    }
+
+    std::string xsymbol_index::comment(const std::string& code, const std::string& name, int& line)
+    {
+        // Code and comments of each line, string and character literals
+        // left out.
+        struct line_parts
+        {
+            std::string code;
+            std::string comment;
+        };
+        std::vector<line_parts> lines(1);
+        const std::size_t size = code.size();
+        std::size_t i = 0;
+        while (i < size)
+        {
+            const char c = code[i];
+            if (c == '\n')
+            {
+                lines.emplace_back();
+                ++i;
+            }
+            else if (c == '/' && i + 1 < size && code[i + 1] == '/')
+            {
+                const std::size_t end = std::min(code.find('\n', i), size);
+                lines.back().comment += code.substr(i, end - i);
+                i = end;
+            }
+            else if (c == '/' && i + 1 < size && code[i + 1] == '*')
+            {
+                std::size_t end = code.find("*/", i + 2);
+                end = end == std::string::npos ? size : end + 2;
+                for (; i < end; ++i)
+                {
+                    if (code[i] == '\n')
+                    {
+                        lines.emplace_back();
+                    }
+                    else
+                    {
+                        lines.back().comment += code[i];
+                    }
+                }
+            }
+            else if (c == '"' || c == '\'')
+            {
+                ++i;
+                while (i < size && code[i] != c && code[i] != '\n')
+                {
+                    i += code[i] == '\\' ? 2 : 1;
+                }
+                ++i;
+                lines.back().code += ' ';
+            }
+            else
+            {
+                lines.back().code += c;
+                ++i;
+            }
+        }
+
+        auto declares = [&name](const std::string& text)
+        {
+            for (std::size_t pos = text.find(name); pos != std::string::npos; pos = text.find(name, pos + 1))
+            {
+                const std::size_t end = pos + name.size();
+                if ((pos == 0 || !is_identifier_char(text[pos - 1]))
+                    && (end == text.size() || !is_identifier_char(text[end])))
+                {
+                    return true;
+                }
+            }
+            return false;
+        };
+        auto is_blank = [](const std::string& text)
+        {
+            return text.find_first_not_of(" \t\r") == std::string::npos;
+        };
+
+        line = 0;
+        for (std::size_t l = 0; l < lines.size(); ++l)
+        {
+            if (!declares(lines[l].code))
+            {
+                continue;
+            }
+            line = static_cast<int>(l + 1);
+            std::string res;
+            for (std::size_t above = l; above > 0; --above)
+            {
+                const line_parts& parts = lines[above - 1];
+                if (!is_blank(parts.code) || is_blank(parts.comment))
+                {
+                    break;
+                }
+                res = parts.comment + (res.empty() ? "" : "\n") + res;
+            }
+            return strip_comment(res.empty() ? lines[l].comment : res);
+        }
+        return "";
+    }
+}
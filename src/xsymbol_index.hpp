@@ -0,0 +1,93 @@
+/************************************************************************************
+ * Copyright (c) 2025, xeus-cpp contributors                                        *
+ *                                                                                  *
+ * Distributed under the terms of the BSD 3-Clause License.                         *
+ *                                                                                  *
+ * The full license is in the file LICENSE, distributed with this software.         *
+ ************************************************************************************/
+
+#ifndef XEUS_CPP_SYMBOL_INDEX_HPP
+#define XEUS_CPP_SYMBOL_INDEX_HPP
+
+#include <cstddef>
+#include <functional>
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "xeus-cpp/xeus_cpp_config.hpp"
+
+namespace xcpp
+{
+    struct xsymbol
+    {
+        std::string name;
+        // function, class, enum, template, typedef, variable or namespace.
+        std::string kind;
+        // The signatures of the overloads of a function, the type and name
+        // of a variable, empty for the other kinds.
+        std::vector<std::string> declarations;
+        // Execution count of the cell that declared or last changed it, 0
+        // for the declarations that do not come from a cell.
+        int execution_count;
+        // Line of the declaration in the cell, from 1, and the comment
+        // attached to it.
+        int line = 0;
+        std::string comment = {};
+    };
+
+    // Kind, declarations, location and comment of a symbol, as shown when
+    // inspecting it.
+    XEUS_CPP_API
+    std::string summary(const xsymbol& symbol);
+    XEUS_CPP_API
+    std::string markdown_summary(const xsymbol& symbol);
+
+    /*****************
+     * xsymbol_index *
+     *****************/
+
+    // Names declared at global scope by the cells, with their kinds and
+    // signatures. The index is updated after each successful cell from the
+    // names the global scope gained, restricted to those appearing in the
+    // cell so that the content of the headers it includes is left out.
+    // Lookups and prefix queries do not involve the compiler.
+    class XEUS_CPP_API xsymbol_index
+    {
+    public:
+
+        using symbol_map = std::map<std::string, xsymbol, std::less<>>;
+
+        // Records the names already declared, which are not indexed.
+        void snapshot();
+        void update(const std::string& code, int execution_count);
+
+        void insert(xsymbol symbol);
+        const xsymbol* find(const std::string& name) const;
+        // The symbol declared by the cells under `name`, or any declaration
+        // visible to the interpreter under this name, qualified or not.
+        // Declarations are described once until the next update().
+        const xsymbol* describe(const std::string& name);
+        // Symbols whose name starts with `prefix`, in alphabetical order.
+        std::vector<const xsymbol*> complete(const std::string& prefix) const;
+        const symbol_map& symbols() const;
+
+        // Identifiers appearing in `code`, outside of comments and literals.
+        static std::set<std::string> identifiers(const std::string& code);
+        // Comment attached to the first line of `code` where `name` appears:
+        // the comment lines right above it, or else the comment ending the
+        // line. `line` is set to the line, 0 if `name` does not appear.
+        static std::string comment(const std::string& code, const std::string& name, int& line);
+
+    private:
+
+        std::set<std::string> m_known;
+        symbol_map m_symbols;
+        // Declarations described outside of the cells, with an empty kind
+        // for the names that are not declared.
+        std::map<std::string, xsymbol, std::less<>> m_described;
+    };
+}
+
+#endif
@@ -0,0 +1,415 @@
+/************************************************************************************
+ * Copyright (c) 2025, xeus-cpp contributors                                        *
+ *                                                                                  *
+ * Distributed under the terms of the BSD 3-Clause License.                         *
+ *                                                                                  *
+ * The full license is in the file LICENSE, distributed with this software.         *
+ ************************************************************************************/
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <limits>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <utility>
+#include <vector>
+
+#include <nlohmann/json.hpp>
+
+#include "xtagfile_index.hpp"
+
+#if !defined(_WIN32)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace nl = nlohmann;
+
+namespace xcpp
+{
+    /****************
+     * xmapped_file *
+     ****************/
+
+    // Read-only view of a file. The file is mapped where mmap is available
+    // and read into memory otherwise.
+    class xmapped_file
+    {
+    public:
+
+        explicit xmapped_file(const std::string& path);
+        ~xmapped_file();
+
+        xmapped_file(const xmapped_file&) = delete;
+        xmapped_file& operator=(const xmapped_file&) = delete;
+
+        const char* data() const;
+        std::size_t size() const;
+
+    private:
+
+        const char* m_data;
+        std::size_t m_size;
+        bool m_mapped;
+        std::string m_content;
+    };
+
+    xmapped_file::xmapped_file(const std::string& path)
+        : m_data(nullptr)
+        , m_size(0)
+        , m_mapped(false)
+    {
+#if !defined(_WIN32)
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0)
+        {
+            return;
+        }
+        struct stat st;
+        if (::fstat(fd, &st) == 0 && st.st_size > 0)
+        {
+            void* data = ::mmap(nullptr, static_cast<std::size_t>(st.st_size), PROT_READ, MAP_SHARED, fd, 0);
+            if (data != MAP_FAILED)
+            {
+                m_data = static_cast<const char*>(data);
+                m_size = static_cast<std::size_t>(st.st_size);
+                m_mapped = true;
+            }
+        }
+        // The mapping stays valid once the descriptor is closed.
+        ::close(fd);
+#else
+        std::ifstream file(path, std::ios::binary);
+        m_content.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+        m_data = m_content.data();
+        m_size = m_content.size();
+#endif
+    }
+
+    xmapped_file::~xmapped_file()
+    {
+#if !defined(_WIN32)
+        if (m_mapped)
+        {
+            ::munmap(const_cast<char*>(m_data), m_size);
+        }
+#endif
+    }
+
+    const char* xmapped_file::data() const
+    {
+        return m_data;
+    }
+
+    std::size_t xmapped_file::size() const
+    {
+        return m_size;
+    }
+
+    namespace
+    {
+        // Layout of a compiled index: the header, the records of the entries
+        // then of the members, each sorted by key, and the string table.
+        // Strings are referenced by offset and size in the table. Integers
+        // are stored in the byte order of the machine that wrote the file,
+        // which is recorded to reject the files of another one.
+        constexpr char index_magic[8] = {'X', 'C', 'P', 'P', 'T', 'A', 'G', 'S'};
+        constexpr std::uint32_t index_byte_order = 0x01020304;
+        constexpr std::uint32_t index_version = 1;
+
+        struct index_header
+        {
+            char magic[8];
+            std::uint32_t byte_order;
+            std::uint32_t version;
+            // Number of entries and of members.
+            std::uint32_t counts[2];
+            std::uint32_t strings_offset;
+            std::uint32_t strings_size;
+        };
+
+        struct index_string
+        {
+            std::uint32_t offset;
+            std::uint32_t size;
+        };
+
+        struct index_record
+        {
+            index_string key;
+            index_string base;
+            index_string page;
+        };
+
+        std::string entry_key(const std::string& kind, const std::string& name)
+        {
+            return kind + '\0' + name;
+        }
+
+        std::string member_key(const std::string& class_name, const std::string& kind, const std::string& name)
+        {
+            return class_name + '\0' + kind + '\0' + name;
+        }
+
+        std::string_view string_at(std::string_view strings, const index_string& ref)
+        {
+            return ref.offset <= strings.size() ? strings.substr(ref.offset, ref.size) : std::string_view();
+        }
+    }
+
+    /*********************************
+     * xtagfile_index implementation *
+     *********************************/
+
+    xtagfile_index xtagfile_index::load(const std::string& tagconf_dir, const std::string& tagfile_dir)
+    {
+        xtagfile_index index;
+        std::error_code ec;
+        for (const auto& entry : std::filesystem::directory_iterator(tagconf_dir, ec))
+        {
+            if (entry.path().extension() != ".json")
+            {
+                continue;
+            }
+            std::ifstream i(entry.path());
+            nl::json tagconf = nl::json::parse(i, nullptr, false);
+            if (tagconf.is_discarded() || !tagconf.contains("url") || !tagconf.contains("tagfile"))
+            {
+                continue;
+            }
+            const std::string filename = tagfile_dir + "/" + tagconf["tagfile"].get<std::string>();
+            pugi::xml_document doc;
+            if (doc.load_file(filename.c_str()))
+            {
+                index.add(doc, tagconf["url"].get<std::string>());
+            }
+        }
+        return index;
+    }
+
+    void xtagfile_index::add(const pugi::xml_node& tagfile, const std::string& url)
+    {
+        entry_map entries;
+        entry_map members;
+        add_node(tagfile, url, entries, members);
+        for (auto& [key, value] : entries)
+        {
+            m_entries.insert_or_assign(key, std::move(value));
+        }
+        for (auto& [key, value] : members)
+        {
+            m_members.insert_or_assign(key, std::move(value));
+        }
+    }
+
+    bool xtagfile_index::save(const std::string& path) const
+    {
+        std::string strings;
+        std::unordered_map<std::string, index_string> interned;
+        auto intern = [&strings, &interned](const std::string& value)
+        {
+            auto [it, inserted] = interned.try_emplace(value);
+            if (inserted)
+            {
+                it->second = {static_cast<std::uint32_t>(strings.size()), static_cast<std::uint32_t>(value.size())};
+                strings += value;
+            }
+            return it->second;
+        };
+
+        index_header header = {};
+        std::memcpy(header.magic, index_magic, sizeof(index_magic));
+        header.byte_order = index_byte_order;
+        header.version = index_version;
+
+        std::vector<index_record> records;
+        const entry_map* tables[2] = {&m_entries, &m_members};
+        for (std::size_t table = 0; table < 2; ++table)
+        {
+            std::vector<const entry_map::value_type*> sorted;
+            sorted.reserve(tables[table]->size());
+            for (const auto& entry : *tables[table])
+            {
+                sorted.push_back(&entry);
+            }
+            std::sort(
+                sorted.begin(),
+                sorted.end(),
+                [](const auto* lhs, const auto* rhs)
+                {
+                    return lhs->first < rhs->first;
+                }
+            );
+            for (const auto* entry : sorted)
+            {
+                records.push_back({intern(entry->first), intern(entry->second.first), intern(entry->second.second)});
+            }
+            header.counts[table] = static_cast<std::uint32_t>(sorted.size());
+        }
+
+        const std::size_t strings_offset = sizeof(index_header) + records.size() * sizeof(index_record);
+        if (strings_offset + strings.size() > std::numeric_limits<std::uint32_t>::max())
+        {
+            return false;
+        }
+        header.strings_offset = static_cast<std::uint32_t>(strings_offset);
+        header.strings_size = static_cast<std::uint32_t>(strings.size());
+
+        // Written aside then renamed, so that the kernels mapping the
+        // previous file keep reading it.
+        const std::string tmp_path = path + ".tmp";
+        {
+            std::ofstream out(tmp_path, std::ios::binary | std::ios::trunc);
+            out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+            out.write(
+                reinterpret_cast<const char*>(records.data()),
+                static_cast<std::streamsize>(records.size() * sizeof(index_record))
+            );
+            out.write(strings.data(), static_cast<std::streamsize>(strings.size()));
+            if (!out)
+            {
+                return false;
+            }
+        }
+        std::error_code ec;
+        std::filesystem::rename(tmp_path, path, ec);
+        return !ec;
+    }
+
+    bool xtagfile_index::open(const std::string& path)
+    {
+        auto file = std::make_shared<const xmapped_file>(path);
+        index_header header;
+        if (file->size() < sizeof(header))
+        {
+            return false;
+        }
+        std::memcpy(&header, file->data(), sizeof(header));
+        const std::size_t records_size = (std::size_t(header.counts[0]) + header.counts[1]) * sizeof(index_record);
+        if (std::memcmp(header.magic, index_magic, sizeof(index_magic)) != 0
+            || header.byte_order != index_byte_order || header.version != index_version
+            || sizeof(header) + records_size > header.strings_offset
+            || std::size_t(header.strings_offset) + header.strings_size > file->size())
+        {
+            return false;
+        }
+        m_entries.clear();
+        m_members.clear();
+        m_file = std::move(file);
+        return true;
+    }
+
+    std::string xtagfile_index::find(const std::string& kind, const std::string& name) const
+    {
+        const std::string key = entry_key(kind, name);
+        auto it = m_entries.find(key);
+        return it != m_entries.end() ? it->second.first + it->second.second : find_compiled(0, key);
+    }
+
+    std::string
+    xtagfile_index::find_member(const std::string& class_name, const std::string& kind, const std::string& name) const
+    {
+        const std::string key = member_key(class_name, kind, name);
+        auto it = m_members.find(key);
+        return it != m_members.end() ? it->second.first + it->second.second : find_compiled(1, key);
+    }
+
+    std::size_t xtagfile_index::size() const
+    {
+        std::size_t res = m_entries.size() + m_members.size();
+        if (m_file)
+        {
+            index_header header;
+            std::memcpy(&header, m_file->data(), sizeof(header));
+            res += std::size_t(header.counts[0]) + header.counts[1];
+        }
+        return res;
+    }
+
+    void xtagfile_index::add_node(
+        const pugi::xml_node& node,
+        const std::string& url,
+        entry_map& entries,
+        entry_map& members
+    )
+    {
+        for (pugi::xml_node child : node.children())
+        {
+            const std::string kind = child.attribute("kind").value();
+            const std::string name = child.child("name").child_value();
+            if (!kind.empty() && !name.empty())
+            {
+                // Classes are documented on their own page, other entries
+                // on an anchor of the page of their parent.
+                const bool is_class = kind == "class" || kind == "struct";
+                std::string page = child.child(is_class ? "filename" : "anchorfile").child_value();
+                if (!page.empty())
+                {
+                    entries.try_emplace(entry_key(kind, name), url, std::move(page));
+                }
+                if (is_class)
+                {
+                    for (pugi::xml_node member : child.children())
+                    {
+                        const std::string member_name = member.child("name").child_value();
+                        std::string member_page = member.child("anchorfile").child_value();
+                        if (!member_name.empty() && !member_page.empty())
+                        {
+                            members.try_emplace(
+                                member_key(name, member.attribute("kind").value(), member_name),
+                                url,
+                                std::move(member_page)
+                            );
+                        }
+                    }
+                }
+            }
+            add_node(child, url, entries, members);
+        }
+    }
+
+    std::string xtagfile_index::find_compiled(std::size_t table, std::string_view key) const
+    {
+        if (!m_file)
+        {
+            return "";
+        }
+        const char* data = m_file->data();
+        index_header header;
+        std::memcpy(&header, data, sizeof(header));
+        const char* records = data + sizeof(header) + (table == 0 ? 0 : header.counts[0]) * sizeof(index_record);
+        const std::string_view strings(data + header.strings_offset, header.strings_size);
+
+        std::size_t first = 0;
+        std::size_t last = header.counts[table];
+        while (first < last)
+        {
+            const std::size_t middle = first + (last - first) / 2;
+            index_record record;
+            std::memcpy(&record, records + middle * sizeof(index_record), sizeof(record));
+            const int cmp = string_at(strings, record.key).compare(key);
+            if (cmp == 0)
+            {
+                std::string res(string_at(strings, record.base));
+                res += string_at(strings, record.page);
+                return res;
+            }
+            if (cmp < 0)
+            {
+                first = middle + 1;
+            }
+            else
+            {
+                last = middle;
+            }
+        }
+        return "";
+    }
+}
@@ -0,0 +1,81 @@
+/************************************************************************************
+ * Copyright (c) 2025, xeus-cpp contributors                                        *
+ *                                                                                  *
+ * Distributed under the terms of the BSD 3-Clause License.                         *
+ *                                                                                  *
+ * The full license is in the file LICENSE, distributed with this software.         *
+ ************************************************************************************/
+
+#ifndef XEUS_CPP_TAGFILE_INDEX_HPP
+#define XEUS_CPP_TAGFILE_INDEX_HPP
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+
+#include <pugixml.hpp>
+
+#include "xeus-cpp/xeus_cpp_config.hpp"
+
+namespace xcpp
+{
+    // Name of the compiled index of the tagfiles, in the tagfile directory.
+    constexpr const char* compiled_tagfile_index = "xcpp-tags.index";
+
+    class xmapped_file;
+
+    /******************
+     * xtagfile_index *
+     ******************/
+
+    // Documentation URLs of the entries of Doxygen tagfiles, indexed by kind
+    // and qualified name, and by class and member for the members of classes
+    // and structs. When several tagfiles document the same entry, the last
+    // one added wins; within a tagfile, the first entry wins.
+    //
+    // An index can be saved in a compact binary form: the keys and URLs in a
+    // string table and the entries in arrays sorted by key. Opening it maps
+    // the file read-only and looks the entries up by binary search, so that
+    // the kernels of a node share its pages and do not parse the tagfiles.
+    class XEUS_CPP_API xtagfile_index
+    {
+    public:
+
+        // Indexes the tagfiles found in `tagfile_dir` listed by the JSON files
+        // of `tagconf_dir`, each giving the "tagfile" name and the base "url"
+        // of its pages. Missing files and files that fail to parse are skipped.
+        static xtagfile_index load(const std::string& tagconf_dir, const std::string& tagfile_dir);
+
+        void add(const pugi::xml_node& tagfile, const std::string& url);
+
+        // Only the entries added to the index are saved, not those of the
+        // file it was opened from.
+        bool save(const std::string& path) const;
+        // Replaces the content of the index with the one of a file written
+        // by save(), false if it cannot be read or is not such a file.
+        bool open(const std::string& path);
+
+        // URL of the entry, empty if there is none.
+        std::string find(const std::string& kind, const std::string& name) const;
+        std::string find_member(const std::string& class_name, const std::string& kind, const std::string& name) const;
+
+        std::size_t size() const;
+
+    private:
+
+        // Base URL of the tagfile and page of the entry.
+        using entry_map = std::unordered_map<std::string, std::pair<std::string, std::string>>;
+
+        void add_node(const pugi::xml_node& node, const std::string& url, entry_map& entries, entry_map& members);
+        std::string find_compiled(std::size_t table, std::string_view key) const;
+
+        entry_map m_entries;
+        entry_map m_members;
+        std::shared_ptr<const xmapped_file> m_file;
+    };
+}
+
+#endif
@@ -87,4 +87,55 @@ namespace xcpp
 
         return prefix + "share" + separator + "xeus-cpp" + separator + "tagfiles";
     }
+
+    std::string retrieve_docs_dir()
+    {
+        const char* docs_dir_env = std::getenv("XCPP_DOCS_DIR");
+        if (docs_dir_env != nullptr)
+        {
+            return docs_dir_env;
+        }
+
+        std::string prefix = xeus::prefix_path();
+
+#if defined(_WIN32)
+        const char separator = '\\';
+#else
+        const char separator = '/';
+#endif
+
+        return prefix + "share" + separator + "xeus-cpp" + separator + "docs";
+    }
+
+    std::string retrieve_cache_dir()
+    {
+        const char* cache_dir_env = std::getenv("XCPP_CACHE_DIR");
+        if (cache_dir_env != nullptr)
+        {
+            return cache_dir_env;
+        }
+
+#if defined(_WIN32)
+        const char separator = '\\';
+        const char* base_env = std::getenv("LOCALAPPDATA");
+        if (base_env != nullptr)
+        {
+            return std::string(base_env) + separator + "xeus-cpp" + separator + "cache";
+        }
+#else
+        const char separator = '/';
+        const char* base_env = std::getenv("XDG_CACHE_HOME");
+        if (base_env != nullptr && *base_env != '\0')
+        {
+            return std::string(base_env) + separator + "xeus-cpp";
+        }
+        const char* home_env = std::getenv("HOME");
+        if (home_env != nullptr)
+        {
+            return std::string(home_env) + separator + ".cache" + separator + "xeus-cpp";
+        }
+#endif
+
+        return "";
+    }
 }
@@ -0,0 +1,107 @@
+/************************************************************************************
+ * Copyright (c) 2025, xeus-cpp contributors                                        *
+ *                                                                                  *
+ * Distributed under the terms of the BSD 3-Clause License.                         *
+ *                                                                                  *
+ * The full license is in the file LICENSE, distributed with this software.         *
+ ************************************************************************************/
+
+// Time of the text representation of a std::vector of numbers by
+// mime_bundle_repr, which writes the elements with std::to_chars, against
+// a std::ostringstream joining the same elements, as the stream path does.
+// No element is elided and the HTML table is not generated.
+//
+//     bench_mime_bundle_repr [elements]
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdlib>
+#include <iostream>
+#include <limits>
+#include <locale>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "xcpp/xmime.hpp"
+
+namespace
+{
+    template <class T>
+    std::string stream_repr(const std::vector<T>& values)
+    {
+        std::ostringstream out;
+        out.imbue(std::locale::classic());
+        out.precision(std::numeric_limits<T>::max_digits10);
+        out << "{ ";
+        for (std::size_t i = 0; i < values.size(); ++i)
+        {
+            out << (i == 0 ? "" : ", ") << values[i];
+        }
+        out << " }";
+        return out.str();
+    }
+
+    // Best of a few runs, in seconds, to leave out the noise of the machine.
+    template <class F>
+    double best_time(F&& format)
+    {
+        double best = std::numeric_limits<double>::max();
+        for (int repeat = 0; repeat < 3; ++repeat)
+        {
+            const auto start = std::chrono::steady_clock::now();
+            const std::size_t size = format();
+            const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+            best = std::min(best, elapsed.count());
+            if (size == 0)
+            {
+                std::cerr << "empty output" << std::endl;
+            }
+        }
+        return best;
+    }
+
+    template <class T>
+    void report(const char* name, const std::vector<T>& values)
+    {
+        const double to_chars_time = best_time(
+            [&values]()
+            {
+                return xcpp::mime_bundle_repr(values)["text/plain"].template get_ref<const std::string&>().size();
+            }
+        );
+        const double stream_time = best_time(
+            [&values]()
+            {
+                return stream_repr(values).size();
+            }
+        );
+        const double count = static_cast<double>(values.size());
+        std::cout << name << "\telements=" << values.size() << "\tto_chars=" << to_chars_time << " s ("
+                  << to_chars_time / count * 1e9 << " ns/element)\tstream=" << stream_time << " s ("
+                  << stream_time / count * 1e9 << " ns/element)\tspeedup=" << stream_time / to_chars_time
+                  << std::endl;
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    const std::size_t size = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 10000000;
+
+    xcpp::repr_options& options = xcpp::get_repr_options();
+    options.threshold = std::numeric_limits<std::size_t>::max();
+    options.html = false;
+
+    std::vector<double> doubles(size);
+    std::vector<int> ints(size);
+    for (std::size_t i = 0; i < size; ++i)
+    {
+        doubles[i] = static_cast<double>(i) * 1.0001 - 0.5;
+        ints[i] = static_cast<int>(i * 7919 % 2000003) - 1000000;
+    }
+
+    report("double", doubles);
+    report("int", ints);
+    return 0;
+}
@@ -0,0 +1,167 @@
+/************************************************************************************
+ * Copyright (c) 2025, xeus-cpp contributors                                        *
+ *                                                                                  *
+ * Distributed under the terms of the BSD 3-Clause License.                         *
+ *                                                                                  *
+ * The full license is in the file LICENSE, distributed with this software.         *
+ ************************************************************************************/
+
+// Throughput of xoutput_buffer with threads printing lines with std::endl,
+// against a buffer taking a mutex around every write as the stream buffer
+// did before output was staged per thread. Prints, for each thread count,
+// the lines published per second and the lines broken by the output of
+// another thread.
+//
+//     bench_output_buffer [max_threads] [lines_per_thread]
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdlib>
+#include <functional>
+#include <iostream>
+#include <mutex>
+#include <ostream>
+#include <streambuf>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "xeus-cpp/xbuffer.hpp"
+
+namespace
+{
+    class locked_buffer : public std::streambuf
+    {
+    public:
+
+        using callback_type = std::function<void(const std::string&)>;
+
+        explicit locked_buffer(callback_type callback)
+            : m_callback(std::move(callback))
+        {
+        }
+
+        void flush_pending()
+        {
+        }
+
+    protected:
+
+        int_type overflow(int_type c) override
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (!traits_type::eq_int_type(c, traits_type::eof()))
+            {
+                m_output.push_back(traits_type::to_char_type(c));
+            }
+            return c;
+        }
+
+        std::streamsize xsputn(const char* s, std::streamsize count) override
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_output.append(s, static_cast<std::size_t>(count));
+            return count;
+        }
+
+        int sync() override
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (!m_output.empty())
+            {
+                m_callback(m_output);
+                m_output.clear();
+            }
+            return 0;
+        }
+
+    private:
+
+        callback_type m_callback;
+        std::mutex m_mutex;
+        std::string m_output;
+    };
+
+    struct line_counter
+    {
+        // Lines printed by the benchmark are `line_size` characters long,
+        // including the end of line.
+        static constexpr std::size_t line_size = 32;
+
+        void operator()(const std::string& output)
+        {
+            std::size_t start = 0;
+            for (std::size_t end = output.find('\n'); end != std::string::npos; end = output.find('\n', start))
+            {
+                const std::size_t length = m_partial + end + 1 - start;
+                ++(length == line_size ? m_lines : m_broken);
+                m_partial = 0;
+                start = end + 1;
+            }
+            m_partial += output.size() - start;
+        }
+
+        std::size_t m_lines = 0;
+        std::size_t m_broken = 0;
+        std::size_t m_partial = 0;
+    };
+
+    template <class B>
+    double run(std::size_t threads, std::size_t lines, line_counter& counter)
+    {
+        B buffer(std::ref(counter));
+        const auto start = std::chrono::steady_clock::now();
+        std::vector<std::thread> writers;
+        for (std::size_t t = 0; t < threads; ++t)
+        {
+            writers.emplace_back(
+                [&buffer, lines, t]()
+                {
+                    std::ostream out(&buffer);
+                    for (std::size_t i = 0; i < lines; ++i)
+                    {
+                        out << "thread " << t % 10 << " line " << 10000000 + i % 10000000 << " abcdefgh"
+                            << std::endl;
+                    }
+                }
+            );
+        }
+        for (auto& writer : writers)
+        {
+            writer.join();
+        }
+        buffer.flush_pending();
+        const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+        return static_cast<double>(threads * lines) / elapsed.count();
+    }
+
+    template <class B>
+    void report(const char* name, std::size_t threads, std::size_t lines)
+    {
+        // Best of a few runs, to leave out the noise of the machine.
+        double best = 0;
+        line_counter counter;
+        for (int repeat = 0; repeat < 5; ++repeat)
+        {
+            counter = line_counter();
+            best = std::max(best, run<B>(threads, lines, counter));
+        }
+        std::cout << name << "\tthreads=" << threads << "\tMlines/s=" << best / 1e6
+                  << "\tns/line=" << 1e9 / best
+                  << "\tbroken=" << counter.m_broken << std::endl;
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    const std::size_t max_threads = argc > 1 ? std::strtoul(argv[1], nullptr, 10)
+                                             : std::max(1u, std::thread::hardware_concurrency());
+    const std::size_t lines = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 200000;
+    for (std::size_t threads = 1; threads <= max_threads; threads *= 2)
+    {
+        report<locked_buffer>("locked", threads, lines);
+        report<xcpp::xoutput_buffer>("staged", threads, lines);
+    }
+    return 0;
+}
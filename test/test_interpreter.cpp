@@ -6,27 +6,60 @@
  * The full license is in the file LICENSE, distributed with this software.
  ****************************************************************************/
 
+#include <array>
+#include <atomic>
 #include <future>
 
 #include "doctest/doctest.h"
 #include "xeus-cpp/xinterpreter.hpp"
+#include "xeus-cpp/xiopub.hpp"
 #include "xeus-cpp/xholder.hpp"
 #include "xeus-cpp/xmanager.hpp"
 #include "xeus-cpp/xutils.hpp"
 #include "xeus-cpp/xoptions.hpp"
 #include "xeus-cpp/xeus_cpp_config.hpp"
+#include "xcpp/xbinary.hpp"
 #include "xcpp/xmime.hpp"
+#include "xcpp/xthrottled_display.hpp"
 
+#include "../src/xcompiler.hpp"
+#include "../src/xcompletion.hpp"
 #include "../src/xparser.hpp"
 #include "../src/xsystem.hpp"
+#include "../src/xmagics/executable.hpp"
+#include "../src/xmagics/execution.hpp"
+#include "../src/xmagics/opt.hpp"
 #include "../src/xmagics/os.hpp"
+#include "../src/xmagics/stats.hpp"
+#include "../src/xmagics/who.hpp"
 #include "../src/xmagics/xassist.hpp"
 #include "../src/xinspect.hpp"
+#include "../src/xcache.hpp"
+#include "../src/xinterrupt.hpp"
+#include "../src/xlive_output.hpp"
+#include "../src/xlocal_docs.hpp"
+#include "../src/xoptimizer.hpp"
+#include "../src/xoutput_limiter.hpp"
+#include "../src/xstats.hpp"
+#include "../src/xsymbol_index.hpp"
+#include "../src/xtagfile_index.hpp"
 
 
 #include <iostream>
 #include <pugixml.hpp>
+#include <filesystem>
 #include <fstream>
+#include <mutex>
+#include <set>
+#include <sstream>
+#include <stdexcept>
+#include <thread>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <new>
+#include <numeric>
+#include <algorithm>
 #if defined(__GNUC__) && !defined(__EMSCRIPTEN__)
     #include <sys/wait.h>
     #include <unistd.h>
@@ -102,6 +135,61 @@ TEST_SUITE("execute_request")
         REQUIRE(result["status"] == "ok");
     }
 
+#if defined(__GNUC__) && !defined(__EMSCRIPTEN__)
+    TEST_CASE("interrupt")
+    {
+        // Interrupt handling changes the signal mask of the process.
+        pid_t pid = fork();
+        if (pid == 0)
+        {
+            xcpp::init_interrupt_handling();
+            std::vector<const char*> Args = {/*"-v", "resource-dir", "....."*/};
+            xcpp::interpreter interpreter((int)Args.size(), Args.data());
+
+            auto execute = [&interpreter](const std::string& code)
+            {
+                nl::json user_expressions = nl::json::object();
+                xeus::execute_request_config config;
+                config.silent = false;
+                config.store_history = false;
+                config.allow_stdin = false;
+                nl::json header = nl::json::object();
+                xeus::xrequest_context::guid_list id = {};
+                xeus::xrequest_context context(header, id);
+
+                std::promise<nl::json> promise;
+                std::future<nl::json> future = promise.get_future();
+                auto callback = [&promise](nl::json result) {
+                    promise.set_value(result);
+                };
+                interpreter.execute_request(
+                    std::move(context),
+                    std::move(callback),
+                    code,
+                    std::move(config),
+                    user_expressions
+                );
+                return future.get();
+            };
+
+            std::thread([]() {
+                std::this_thread::sleep_for(std::chrono::milliseconds(500));
+                xcpp::request_interrupt();
+            }).detach();
+            nl::json interrupted = execute("volatile int spin = 0; while (true) { ++spin; }");
+            nl::json next = execute("int after_interrupt = spin;");
+            bool success = interrupted["status"] == "error" && interrupted["ename"] == "Interrupted: "
+                           && next["status"] == "ok";
+            _exit(success ? 0 : 1);
+        }
+
+        int status = 0;
+        waitpid(pid, &status, 0);
+        REQUIRE(WIFEXITED(status));
+        REQUIRE(WEXITSTATUS(status) == 0);
+    }
+#endif
+
 #if defined(__EMSCRIPTEN__)
     TEST_CASE("headers found in sysroot/include/compat")
     {
@@ -389,6 +477,66 @@ TEST_SUITE("inspect_request")
         REQUIRE(result["found"] == false);
         REQUIRE(result["status"] == "ok");
     }
+
+    TEST_CASE("declaration_fallback")
+    {
+        std::vector<const char*> Args = {/*"-v", "resource-dir", "....."*/};
+        xcpp::interpreter interpreter((int)Args.size(), Args.data());
+        std::string code = "/// Adds one to its argument.\n"
+                           "int xcpp_add_one(int x) { return x + 1; }\n"
+                           "namespace xcpp_ns { struct xcpp_base {}; struct xcpp_derived : xcpp_base {}; }";
+        nl::json user_expressions = nl::json::object();
+        xeus::execute_request_config config;
+        config.silent = false;
+        config.store_history = false;
+        config.allow_stdin = false;
+        nl::json header = nl::json::object();
+        xeus::xrequest_context::guid_list id = {};
+        xeus::xrequest_context context(header, id);
+
+        std::promise<nl::json> promise;
+        std::future<nl::json> future = promise.get_future();
+        auto callback = [&promise](nl::json result) {
+            promise.set_value(result);
+        };
+
+        interpreter.execute_request(
+            std::move(context),
+            std::move(callback),
+            code,
+            std::move(config),
+            user_expressions
+        );
+        REQUIRE(future.get()["status"] == "ok");
+
+        nl::json result = interpreter.inspect_request("xcpp_add_one", 12, /*detail_level=*/0);
+        REQUIRE(result["found"] == true);
+        std::string markdown = result["data"]["text/markdown"];
+        REQUIRE(markdown.find("Adds one to its argument.") != std::string::npos);
+        REQUIRE(markdown.find("int xcpp_add_one(int x)") != std::string::npos);
+
+        // Names that are not in a tagfile nor declared at global scope by
+        // a cell are described from the interpreter.
+        xcpp::xsymbol_index index;
+        nl::json data = xcpp::inspect_data("xcpp_ns::xcpp_derived", &index);
+        REQUIRE(data["text/plain"].get<std::string>().find("xcpp_ns::xcpp_base") != std::string::npos);
+        REQUIRE(xcpp::inspect_data("xcpp_ns::xcpp_missing", &index).empty());
+    }
+
+    TEST_CASE("find_type_does_not_declare")
+    {
+        std::vector<const char*> Args = {/*"-v", "resource-dir", "....."*/};
+        xcpp::interpreter interpreter((int)Args.size(), Args.data());
+        xcpp::clear_type_cache();
+
+        std::set<std::string> before;
+        Cpp::GetAllCppNames(Cpp::GetGlobalScope(), before);
+        REQUIRE(xcpp::find_type_slow("1.0 + 1") == "double");
+        REQUIRE(xcpp::find_type_slow("1.0 + 1") == "double");
+        std::set<std::string> after;
+        Cpp::GetAllCppNames(Cpp::GetGlobalScope(), after);
+        REQUIRE(after == before);
+    }
 }
 
 TEST_SUITE("kernel_info_request")
@@ -488,6 +636,61 @@ TEST_SUITE("trim"){
 
 }
 
+TEST_SUITE("split_code")
+{
+    TEST_CASE("kinds")
+    {
+        std::string code = "#include <vector>\n"
+                           "int x = 3;\n"
+                           "struct A { int a; };\n"
+                           "int f(int a)\n{\n    return a + 1;\n}\n"
+                           "std::vector<int> v{1, 2};\n"
+                           "v.push_back(x);\n"
+                           "for (int i = 0; i < 3; ++i) { x += i; }\n"
+                           "x = f(x)";
+
+        auto chunks = xcpp::split_code(code);
+
+        REQUIRE(chunks.size() == 8);
+        REQUIRE(chunks[0].kind == xcpp::chunk_kind::preprocessor);
+        REQUIRE(chunks[1].kind == xcpp::chunk_kind::variable);
+        REQUIRE(chunks[2].kind == xcpp::chunk_kind::definition);
+        REQUIRE(chunks[3].kind == xcpp::chunk_kind::definition);
+        REQUIRE(chunks[4].kind == xcpp::chunk_kind::variable);
+        REQUIRE(chunks[5].kind == xcpp::chunk_kind::statement);
+        REQUIRE(chunks[6].kind == xcpp::chunk_kind::statement);
+        REQUIRE(chunks[7].kind == xcpp::chunk_kind::statement);
+    }
+
+    TEST_CASE("literals_and_comments")
+    {
+        std::string code = "// int y; {\n"
+                           "const char* s = \"a; } b\";\n"
+                           "char c = '}';\n"
+                           "long n = 1'000'000;";
+
+        auto chunks = xcpp::split_code(code);
+
+        REQUIRE(chunks.size() == 3);
+        REQUIRE(chunks[0].code.find("const char* s") != std::string::npos);
+        REQUIRE(chunks[2].kind == xcpp::chunk_kind::variable);
+    }
+
+    TEST_CASE("function_prototype")
+    {
+        std::string prototype;
+        std::string name;
+
+        REQUIRE(xcpp::function_prototype("double scale(double x, int n = 2)\n{\n    return x * n;\n}", prototype, name));
+        REQUIRE(prototype == "double scale(double x, int n = 2);");
+        REQUIRE(name == "scale");
+
+        REQUIRE_FALSE(xcpp::function_prototype("template <class T> T id(T t) { return t; }", prototype, name));
+        REQUIRE_FALSE(xcpp::function_prototype("inline int one() { return 1; }", prototype, name));
+        REQUIRE_FALSE(xcpp::function_prototype("struct S { int a; };", prototype, name));
+    }
+}
+
 TEST_SUITE("is_match_magics_manager")
 {
     // This test case checks if the function `is_match` correctly identifies strings that match
@@ -589,6 +792,108 @@ TEST_SUITE("xbuffer")
         REQUIRE(callback_output == "Hello, world!");
     }
 
+    TEST_CASE("xoutput_buffer_coalesces_flushes")
+    {
+        std::mutex mutex;
+        std::vector<std::string> messages;
+        auto callback = [&](const std::string& value)
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            messages.push_back(value);
+        };
+        xcpp::xoutput_buffer buffer(callback);
+        // The interval never elapses during the test, the flushes are
+        // published by flush_pending only.
+        buffer.set_coalescing(std::chrono::milliseconds(3600000), 0);
+        std::ostream stream(&buffer);
+
+        std::string lines;
+        for (int i = 0; i < 100; ++i)
+        {
+            stream << "line " << i << std::endl;
+            lines += "line " + std::to_string(i) + "\n";
+        }
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            REQUIRE(messages.empty());
+        }
+        buffer.flush_pending();
+        stream << "last" << std::flush;
+        buffer.flush_pending();
+
+        std::lock_guard<std::mutex> lock(mutex);
+        REQUIRE(messages.size() == 2);
+        REQUIRE(messages[0] == lines);
+        REQUIRE(messages[1] == "last");
+    }
+
+    TEST_CASE("xoutput_buffer_publishes_above_size_threshold")
+    {
+        std::vector<std::string> messages;
+        auto callback = [&messages](const std::string& value)
+        {
+            messages.push_back(value);
+        };
+        xcpp::xoutput_buffer buffer(callback);
+        buffer.set_coalescing(std::chrono::milliseconds(60000), 8);
+        std::ostream stream(&buffer);
+
+        stream << "1234" << std::flush;
+        REQUIRE(messages.empty());
+        stream << "56789" << std::flush;
+        REQUIRE(messages.size() == 1);
+        REQUIRE(messages[0] == "123456789");
+    }
+
+    TEST_CASE("xoutput_buffer_keeps_lines_of_threads_whole")
+    {
+        std::vector<std::string> lines;
+        auto callback = [&lines](const std::string& value)
+        {
+            std::istringstream iss(value);
+            std::string line;
+            while (std::getline(iss, line))
+            {
+                lines.push_back(line);
+            }
+        };
+        xcpp::xoutput_buffer buffer(callback);
+
+        std::vector<std::thread> threads;
+        for (int t = 0; t < 4; ++t)
+        {
+            threads.emplace_back(
+                [&buffer, t]()
+                {
+                    std::ostream stream(&buffer);
+                    for (int i = 0; i < 1000; ++i)
+                    {
+                        stream << "thread " << t << " line " << i << std::endl;
+                    }
+                }
+            );
+        }
+        for (std::thread& thread : threads)
+        {
+            thread.join();
+        }
+        buffer.flush_pending();
+
+        REQUIRE(lines.size() == 4000);
+        std::vector<int> next(4, 0);
+        for (const std::string& line : lines)
+        {
+            int t = -1;
+            int i = -1;
+            REQUIRE(std::sscanf(line.c_str(), "thread %d line %d", &t, &i) == 2);
+            // Lines of a thread are published whole and in order.
+            REQUIRE(line == "thread " + std::to_string(t) + " line " + std::to_string(i));
+            REQUIRE(t >= 0);
+            REQUIRE(t < 4);
+            REQUIRE(i == next[static_cast<std::size_t>(t)]++);
+        }
+    }
+
     // This test case checks if the `xinput_buffer` correctly calls the callback function
     // when the buffer is flushed. It sets up a scenario where a `xinput_buffer` object is
     // created with a callback function, and checks if the callback function is called when
@@ -664,6 +969,539 @@ TEST_SUITE("xbuffer")
     }
 }
 
+TEST_SUITE("xlive_output")
+{
+    TEST_CASE("complete_utf8_prefix")
+    {
+        REQUIRE(xcpp::xlive_output::complete_utf8_prefix("abc") == 3);
+        REQUIRE(xcpp::xlive_output::complete_utf8_prefix("ab\xc3\xa9") == 4);
+        REQUIRE(xcpp::xlive_output::complete_utf8_prefix("ab\xc3") == 2);
+        REQUIRE(xcpp::xlive_output::complete_utf8_prefix("a\xe2\x82") == 1);
+        REQUIRE(xcpp::xlive_output::complete_utf8_prefix("\xe2\x82\xac") == 3);
+    }
+
+#if !defined(_WIN32) && !defined(__EMSCRIPTEN__)
+    TEST_CASE("forwards_while_running")
+    {
+        std::vector<std::string> chunks;
+        std::size_t before_end = 0;
+        {
+            xcpp::xlive_output output(
+                [&chunks](const std::string& chunk)
+                {
+                    chunks.push_back(chunk);
+                }
+            );
+            std::printf("progress\n");
+            std::this_thread::sleep_for(std::chrono::milliseconds(500));
+            before_end = chunks.size();
+            std::string large(200000, 'x');
+            std::fwrite(large.data(), 1, large.size(), stdout);
+        }
+
+        // Forwarded by the periodic flush, before the end of the capture.
+        REQUIRE(before_end == 1);
+        REQUIRE(chunks[0] == "progress\n");
+        std::size_t total = 0;
+        for (const std::string& chunk : chunks)
+        {
+            total += chunk.size();
+        }
+        REQUIRE(total == 200009);
+    }
+#endif
+}
+
+TEST_SUITE("xiopub")
+{
+    TEST_CASE("publish_serialized")
+    {
+        // Publishers never overlap, whatever their thread.
+        std::atomic<int> inside(0);
+        std::atomic<bool> overlapped(false);
+        auto publish = [&]()
+        {
+            for (int i = 0; i < 1000; ++i)
+            {
+                xcpp::publish_serialized(
+                    [&]()
+                    {
+                        if (inside.fetch_add(1) != 0)
+                        {
+                            overlapped = true;
+                        }
+                        // Publishing again from the same thread is allowed.
+                        xcpp::publish_serialized([]() {});
+                        inside.fetch_sub(1);
+                    }
+                );
+            }
+        };
+        xcpp::begin_cell_output([]() {});
+        std::thread other(publish);
+        publish();
+        other.join();
+        xcpp::end_cell_output();
+
+        REQUIRE_FALSE(overlapped);
+    }
+
+    TEST_CASE("held_between_cells")
+    {
+        std::vector<std::string> published;
+        xcpp::begin_cell_output([]() {});
+        xcpp::end_cell_output();
+
+        std::thread(
+            [&published]()
+            {
+                xcpp::publish_serialized(
+                    [&published]()
+                    {
+                        published.push_back("thread");
+                    }
+                );
+            }
+        ).join();
+        // The shell thread still publishes, the other threads wait for the
+        // next cell.
+        xcpp::publish_serialized(
+            [&published]()
+            {
+                published.push_back("shell");
+            }
+        );
+        REQUIRE(published == std::vector<std::string>{"shell"});
+
+        xcpp::begin_cell_output(
+            [&published]()
+            {
+                published.push_back("start");
+            }
+        );
+        xcpp::end_cell_output();
+        REQUIRE(published == std::vector<std::string>{"shell", "start", "thread"});
+    }
+}
+
+TEST_SUITE("xlocal_docs")
+{
+    TEST_CASE("extract_html")
+    {
+        REQUIRE(
+            xcpp::xlocal_docs::relative_path("https://en.cppreference.com/w/cpp/container/vector?action=purge")
+            == "en.cppreference.com/w/cpp/container/vector"
+        );
+        REQUIRE(xcpp::xlocal_docs::relative_path("https://docs/a/../../etc/passwd").empty());
+        REQUIRE(xcpp::xlocal_docs::relative_path("file:///etc/passwd") == "etc/passwd");
+        REQUIRE(xcpp::xlocal_docs::relative_path("//etc/passwd") == "etc/passwd");
+        REQUIRE(xcpp::xlocal_docs::relative_path("docs/cpp/vector/") == "docs/cpp/vector");
+
+        std::string html = "<html><head><style>p{}</style></head><body><div id=\"mw-content-text\" class=\"c\">"
+                           "<div>Vector<script>x()</script></div> text</div><div>footer</div></body></html>";
+        REQUIRE(xcpp::xlocal_docs::extract_html(html) == "<div>Vector</div> text");
+        REQUIRE(xcpp::xlocal_docs::extract_html("<body class=\"x\"><p>Hi</p></body>") == "<p>Hi</p>");
+        REQUIRE(xcpp::xlocal_docs::extract_html("<main><p>M</p></main>") == "<p>M</p>");
+    }
+
+    TEST_CASE("lookup")
+    {
+        std::filesystem::path dir = std::filesystem::temp_directory_path() / "xcpp_local_docs_test";
+        std::filesystem::remove_all(dir);
+        std::filesystem::create_directories(dir / "docs" / "cpp");
+        std::ofstream(dir / "docs" / "cpp" / "vector.html") << "<body><p>Vectors</p></body>";
+        std::ofstream(dir / "docs" / "cpp" / "sort.md") << "# sort";
+
+        xcpp::xlocal_docs docs(dir.string(), 1);
+        nl::json data = docs.lookup("https://docs/cpp/vector");
+        REQUIRE(data["text/html"] == "<p>Vectors</p>");
+        REQUIRE(docs.lookup("https://docs/cpp/vector") == data);
+        REQUIRE(docs.hits() == 1);
+        REQUIRE(docs.lookup("https://docs/cpp/sort")["text/markdown"] == "# sort");
+        REQUIRE(docs.entries() == 1);
+        REQUIRE(docs.lookup("https://docs/cpp/map").empty());
+
+        // Absolute paths are looked up under the directory.
+        std::ofstream(dir / "secret.md") << "# secret";
+        xcpp::xlocal_docs nested((dir / "docs").string(), 4);
+        REQUIRE(nested.lookup((dir / "secret").string()).empty());
+        REQUIRE(nested.lookup("file://" + (dir / "secret").string()).empty());
+        REQUIRE(nested.lookup("/cpp/sort")["text/markdown"] == "# sort");
+
+        std::filesystem::remove_all(dir);
+    }
+}
+
+TEST_SUITE("xoutput_limiter")
+{
+    TEST_CASE("under_budget")
+    {
+        std::string published;
+        xcpp::xoutput_limiter limiter("stdout", [&published](const std::string& s) { published += s; });
+        // The last eighth, 10 bytes, holds the whole last line.
+        limiter.set_budget(80);
+        limiter.start();
+        limiter.write("hello\n");
+        limiter.finish();
+
+        REQUIRE(published == "hello\n");
+        REQUIRE(limiter.spill_path().empty());
+    }
+
+    TEST_CASE("spills_past_budget")
+    {
+        std::string published;
+        xcpp::xoutput_limiter limiter("stdout", [&published](const std::string& s) { published += s; });
+        // The last eighth, 10 bytes, holds the whole last line.
+        limiter.set_budget(80);
+        limiter.start();
+        std::string all;
+        for (int i = 0; i < 1000; ++i)
+        {
+            std::string line = "line " + std::to_string(i) + "\n";
+            all += line;
+            limiter.write(line);
+        }
+        limiter.finish();
+
+        REQUIRE(published.find("line 0\n") == 0);
+        REQUIRE(published.find("line 500\n") == std::string::npos);
+        REQUIRE(published.find("line 999\n") != std::string::npos);
+        REQUIRE(published.size() < all.size());
+
+        std::ifstream spill(limiter.spill_path(), std::ios::binary);
+        std::stringstream content;
+        content << spill.rdbuf();
+        REQUIRE(content.str() == all);
+        spill.close();
+        std::remove(limiter.spill_path().c_str());
+    }
+
+#if !defined(_WIN32)
+    TEST_CASE("caps_spill_directory")
+    {
+        std::filesystem::path dir = std::filesystem::temp_directory_path() / "xcpp_output_spill_test";
+        std::filesystem::remove_all(dir);
+        setenv("XCPP_CACHE_DIR", dir.c_str(), 1);
+
+        std::string published;
+        xcpp::xoutput_limiter limiter("stdout", [&published](const std::string& s) { published += s; });
+        limiter.set_budget(80);
+        limiter.set_spill_limit(2000);
+        std::vector<std::string> paths;
+        for (int cell = 0; cell < 3; ++cell)
+        {
+            limiter.start();
+            for (int i = 0; i < 1000; ++i)
+            {
+                limiter.write("line " + std::to_string(i) + "\n");
+            }
+            limiter.finish();
+            paths.push_back(limiter.spill_path());
+        }
+        unsetenv("XCPP_CACHE_DIR");
+
+        // Each file is cut at half the limit, and the oldest one is removed
+        // to make room for the last.
+        REQUIRE(std::filesystem::file_size(paths.back()) == 1000);
+        REQUIRE(published.find("first 1000 B in " + paths.back()) != std::string::npos);
+        std::uintmax_t size = 0;
+        std::size_t count = 0;
+        for (const auto& entry : std::filesystem::directory_iterator(dir / "output"))
+        {
+            size += entry.file_size();
+            ++count;
+        }
+        REQUIRE(count == 2);
+        REQUIRE(size <= 2000);
+        std::filesystem::remove_all(dir);
+    }
+#endif
+}
+
+TEST_SUITE("xcache")
+{
+    TEST_CASE("key_depends_on_history_flags_and_code")
+    {
+        std::string key = xcpp::xcell_cache::make_key("", "flags", "int a = 1;");
+
+        REQUIRE(key == xcpp::xcell_cache::make_key("", "flags", "int a = 1;"));
+        REQUIRE(key != xcpp::xcell_cache::make_key("parent", "flags", "int a = 1;"));
+        REQUIRE(key != xcpp::xcell_cache::make_key("", "other_flags", "int a = 1;"));
+        REQUIRE(key != xcpp::xcell_cache::make_key("", "flags", "int a = 2;"));
+    }
+
+    TEST_CASE("store_and_lookup")
+    {
+        std::filesystem::path dir = std::filesystem::temp_directory_path() / "xcpp_cell_cache_test";
+        std::filesystem::remove_all(dir);
+        xcpp::xcell_cache cache(dir.string(), 1024 * 1024);
+        REQUIRE(cache.enabled());
+
+        std::string payload;
+        REQUIRE_FALSE(cache.lookup("key", "int x = ;", payload));
+        cache.store("key", "int x = ;", "error: expected expression");
+
+        REQUIRE(cache.lookup("key", "int x = ;", payload));
+        REQUIRE(payload == "error: expected expression");
+        // The cell text is checked to guard against key collisions.
+        REQUIRE_FALSE(cache.lookup("key", "int y = ;", payload));
+        REQUIRE(cache.hits() == 1);
+        REQUIRE(cache.misses() == 2);
+
+        // Entries survive a kernel restart.
+        cache.store("key", "int x = ;", "error: expected expression");
+        xcpp::xcell_cache reloaded(dir.string(), 1024 * 1024);
+        REQUIRE(reloaded.entries() == 1);
+        REQUIRE(reloaded.lookup("key", "int x = ;", payload));
+
+        std::filesystem::remove_all(dir);
+    }
+
+    TEST_CASE("lru_eviction")
+    {
+        std::filesystem::path dir = std::filesystem::temp_directory_path() / "xcpp_cell_cache_lru_test";
+        std::filesystem::remove_all(dir);
+        std::string payload(400, 'e');
+        xcpp::xcell_cache cache(dir.string(), 1000);
+
+        cache.store("a", "a", payload);
+        cache.store("b", "b", payload);
+        std::string out;
+        REQUIRE(cache.lookup("a", "a", out));
+        cache.store("c", "c", payload);
+
+        REQUIRE(cache.size() <= cache.max_size());
+        REQUIRE(cache.lookup("a", "a", out));
+        REQUIRE_FALSE(cache.lookup("b", "b", out));
+        REQUIRE(cache.lookup("c", "c", out));
+
+        std::filesystem::remove_all(dir);
+    }
+
+    TEST_CASE("disabled")
+    {
+        xcpp::xcell_cache cache("", 1024);
+        std::string payload;
+        cache.store("key", "code", "payload");
+
+        REQUIRE_FALSE(cache.enabled());
+        REQUIRE_FALSE(cache.lookup("key", "code", payload));
+        REQUIRE(cache.misses() == 0);
+    }
+}
+
+TEST_SUITE("xstats")
+{
+    TEST_CASE("histogram_percentiles")
+    {
+        xcpp::xhistogram histogram;
+        for (std::uint64_t i = 1; i <= 1000; ++i)
+        {
+            histogram.record(i * 1000);
+        }
+
+        REQUIRE(histogram.count() == 1000);
+        REQUIRE(histogram.min() == 1000);
+        REQUIRE(histogram.max() == 1000000);
+        // Values are reported within the precision of their bucket.
+        REQUIRE(histogram.value_at_percentile(50.) >= 500000);
+        REQUIRE(histogram.value_at_percentile(50.) <= 500000 * 103 / 100);
+        REQUIRE(histogram.value_at_percentile(100.) == 1000000);
+    }
+
+    TEST_CASE("kernel_stats")
+    {
+        xcpp::xstats stats;
+        stats.record("execute_request", "process", std::chrono::milliseconds(2));
+        {
+            xcpp::phase_timer timer(stats, "complete_request", "total");
+        }
+        xcpp::xcell_cache cache("", 0);
+        xcpp::kernel_stats magic(stats, cache);
+
+        nl::json json = magic.to_json();
+        REQUIRE(json["requests"]["execute_request"]["process"]["count"] == 1);
+        REQUIRE(json["requests"]["complete_request"]["total"]["count"] == 1);
+        REQUIRE(json["cell_cache"]["hits"] == 0);
+
+        StreamRedirectRAII redirect(std::cout);
+        magic("kernel_stats --reset");
+        REQUIRE(redirect.getCaptured().find("process") != std::string::npos);
+        REQUIRE(stats.find("execute_request", "process") == nullptr);
+    }
+}
+
+TEST_SUITE("xcompletion_cache")
+{
+    TEST_CASE("filter")
+    {
+        std::vector<std::string> results = {"value_type", "vector", "val", "valarray", "val", "size"};
+        xcpp::xcompletion_cache::filter("val", results);
+        REQUIRE(results == std::vector<std::string>{"value_type", "val", "valarray"});
+    }
+
+    TEST_CASE("filters_longer_token")
+    {
+        xcpp::xcompletion_cache cache;
+        std::vector<std::string> results;
+        REQUIRE_FALSE(cache.lookup("std::", "v", results));
+        cache.store("std::", "v", {"vector", "valarray", "variant", "visit"});
+
+        REQUIRE(cache.lookup("std::", "va", results));
+        REQUIRE(results == std::vector<std::string>{"valarray", "variant"});
+        REQUIRE(cache.lookup("std::", "v", results));
+        REQUIRE(results.size() == 4);
+        // The candidates of "v" do not cover those of a shorter token.
+        REQUIRE_FALSE(cache.lookup("std::", "", results));
+        REQUIRE_FALSE(cache.lookup("int x = std::", "va", results));
+        REQUIRE(cache.hits() == 2);
+        REQUIRE(cache.misses() == 3);
+    }
+
+    TEST_CASE("invalidate")
+    {
+        xcpp::xcompletion_cache cache(2);
+        std::vector<std::string> results;
+        cache.store("a", "", {"x"});
+        cache.store("b", "", {"y"});
+        REQUIRE(cache.lookup("a", "", results));
+        cache.store("c", "", {"z"});
+        // "b" is the least recently used entry.
+        REQUIRE(cache.entries() == 2);
+        REQUIRE_FALSE(cache.lookup("b", "", results));
+        REQUIRE(cache.lookup("a", "", results));
+
+        const auto generation = cache.generation();
+        cache.invalidate();
+        REQUIRE(cache.generation() == generation + 1);
+        REQUIRE(cache.entries() == 0);
+        REQUIRE_FALSE(cache.lookup("a", "", results));
+    }
+}
+
+TEST_SUITE("xcompletion_task")
+{
+    TEST_CASE("completes")
+    {
+        xcpp::xcompletion_task task(
+            "std::",
+            "v",
+            []
+            {
+                return std::vector<std::string>{"vector"};
+            }
+        );
+        REQUIRE(task.wait_for(std::chrono::seconds(10)));
+        REQUIRE(task.context() == "std::");
+        REQUIRE(task.get() == std::vector<std::string>{"vector"});
+    }
+
+    TEST_CASE("exceeds_budget")
+    {
+        std::promise<void> release;
+        std::shared_future<void> released = release.get_future().share();
+        xcpp::xcompletion_task task(
+            "",
+            "",
+            [released]
+            {
+                released.wait();
+                return std::vector<std::string>{"late"};
+            }
+        );
+        REQUIRE_FALSE(task.wait_for(std::chrono::milliseconds(10)));
+        release.set_value();
+        REQUIRE(task.get() == std::vector<std::string>{"late"});
+    }
+}
+
+TEST_SUITE("xsymbol_index")
+{
+    TEST_CASE("identifiers")
+    {
+        std::string code = "int count = 0x1Fu; // total\n"
+                           "const char* s = \"name \\\" quoted\"; /* block */ double d = 1.5e3;";
+        std::set<std::string> identifiers = xcpp::xsymbol_index::identifiers(code);
+        REQUIRE(identifiers == std::set<std::string>{"int", "count", "const", "char", "s", "double", "d"});
+    }
+
+    TEST_CASE("complete")
+    {
+        xcpp::xsymbol_index index;
+        index.insert({"value", "variable", {"int value"}, 1});
+        index.insert({"values", "function", {"int values(int)", "int values()"}, 2});
+        index.insert({"vector3", "class", {}, 2});
+        index.insert({"other", "namespace", {}, 3});
+
+        std::vector<std::string> names;
+        for (const xcpp::xsymbol* symbol : index.complete("val"))
+        {
+            names.push_back(symbol->name);
+        }
+        REQUIRE(names == std::vector<std::string>{"value", "values"});
+        REQUIRE(index.complete("").size() == 4);
+        REQUIRE(index.complete("w").empty());
+
+        // A redeclaration replaces the symbol.
+        index.insert({"value", "variable", {"double value"}, 4});
+        REQUIRE(index.find("value")->execution_count == 4);
+        REQUIRE(index.find("valu") == nullptr);
+        REQUIRE(xcpp::summary(*index.find("value")) == "variable\n    double value\n\nDeclared in cell [4]");
+    }
+
+    TEST_CASE("comment")
+    {
+        std::string code = "#include <vector>\n"
+                           "/// Adds one\n"
+                           "/// to its argument.\n"
+                           "int add_one(int x) { return x + 1; }\n"
+                           "\n"
+                           "/** A point.\n"
+                           " *  With two coordinates.\n"
+                           " */\n"
+                           "struct point { double x, y; };\n"
+                           "int counter = 0; // Number of calls.\n"
+                           "\n"
+                           "const char* s = \"unrelated\"; double unrelated;\n";
+        int line = 0;
+        REQUIRE(xcpp::xsymbol_index::comment(code, "add_one", line) == "Adds one\nto its argument.");
+        REQUIRE(line == 4);
+        REQUIRE(xcpp::xsymbol_index::comment(code, "point", line) == "A point.\nWith two coordinates.");
+        REQUIRE(line == 9);
+        REQUIRE(xcpp::xsymbol_index::comment(code, "counter", line) == "Number of calls.");
+        REQUIRE(line == 10);
+        REQUIRE(xcpp::xsymbol_index::comment(code, "unrelated", line).empty());
+        REQUIRE(line == 12);
+        REQUIRE(xcpp::xsymbol_index::comment(code, "missing", line).empty());
+        REQUIRE(line == 0);
+
+        xcpp::xsymbol symbol{"add_one", "function", {"int add_one(int x)"}, 3, 4, "Adds one"};
+        REQUIRE(
+            xcpp::markdown_summary(symbol)
+            == "```cpp\nint add_one(int x)\n```\n\nAdds one\n\n*function* `add_one`, declared in cell [3], line 4\n"
+        );
+    }
+
+    TEST_CASE("who")
+    {
+        xcpp::xsymbol_index index;
+        xcpp::who magic(index);
+        REQUIRE(magic.report({}, false) == "No declarations.\n");
+
+        index.insert({"f", "function", {"void f(int)"}, 1});
+        index.insert({"point", "class", {}, 2});
+        REQUIRE(magic.report({}, false) == "f\tpoint\n");
+        REQUIRE(magic.report({"class"}, false) == "point\n");
+
+        StreamRedirectRAII redirect(std::cout);
+        magic("who -l function");
+        std::string output = redirect.getCaptured();
+        REQUIRE(output.find("void f(int)") != std::string::npos);
+        REQUIRE(output.find("point") == std::string::npos);
+    }
+}
+
 TEST_SUITE("xoptions")
 {
     TEST_CASE("good_status") {
@@ -758,6 +1596,55 @@ TEST_SUITE("os")
 
 }
 
+TEST_SUITE("timeit")
+{
+    TEST_CASE("format_time")
+    {
+        REQUIRE(xcpp::timeit::format_time(1.5, 3) == "1.5 s");
+        REQUIRE(xcpp::timeit::format_time(0.0025, 3) == "2.5 ms");
+        REQUIRE(xcpp::timeit::format_time(3.25e-6, 3) == "3.25 us");
+        REQUIRE(xcpp::timeit::format_time(4e-9, 3) == "4 ns");
+    }
+
+    TEST_CASE("line")
+    {
+        std::vector<const char*> Args = {/*"-v", "resource-dir", "....."*/};
+        xcpp::interpreter interpreter((int)Args.size(), Args.data());
+        xcpp::timeit t;
+
+        StreamRedirectRAII redirect(std::cout);
+        t("timeit -n 10 -r 3 int timeit_x = 6 * 7;");
+
+        std::string output = redirect.getCaptured();
+        REQUIRE(output.find("per loop (mean +- std. dev. of 3 runs, 10 loops each)") != std::string::npos);
+        REQUIRE(output.find("median") != std::string::npos);
+    }
+
+    TEST_CASE("cell_with_setup")
+    {
+        std::vector<const char*> Args = {/*"-v", "resource-dir", "....."*/};
+        xcpp::interpreter interpreter((int)Args.size(), Args.data());
+        xcpp::timeit t;
+
+        StreamRedirectRAII redirect(std::cout);
+        t("timeit -r 2 int timeit_sum = 0;", "timeit_sum += 1;");
+
+        REQUIRE(redirect.getCaptured().find("of 2 runs") != std::string::npos);
+    }
+
+    TEST_CASE("compilation_error")
+    {
+        std::vector<const char*> Args = {/*"-v", "resource-dir", "....."*/};
+        xcpp::interpreter interpreter((int)Args.size(), Args.data());
+        xcpp::timeit t;
+
+        StreamRedirectRAII redirect(std::cout);
+        t("timeit undeclared_identifier_in_timeit;");
+
+        REQUIRE(redirect.getCaptured().empty());
+    }
+}
+
 TEST_SUITE("xsystem_clone")
 {
     TEST_CASE("clone_xsystem_not_null")
@@ -1014,9 +1901,187 @@ TEST_SUITE("xinspect"){
         cmp.child_value = "nonexistentMethod";
         REQUIRE(cmp(node) == false);
     }
+
+    TEST_CASE("xtagfile_index"){
+        auto append_entry = [](pugi::xml_node parent, const char* tag, const char* kind, const char* name,
+                               const char* page_tag, const char* page)
+        {
+            pugi::xml_node node = parent.append_child(tag);
+            node.append_attribute("kind") = kind;
+            node.append_child("name").append_child(pugi::node_pcdata).set_value(name);
+            node.append_child(page_tag).append_child(pugi::node_pcdata).set_value(page);
+            return node;
+        };
+
+        pugi::xml_document doc;
+        pugi::xml_node tagfile = doc.append_child("tagfile");
+        pugi::xml_node vector = append_entry(tagfile, "compound", "class", "std::vector", "filename", "cpp/vector");
+        append_entry(vector, "member", "function", "push_back", "anchorfile", "cpp/vector/push_back");
+        pugi::xml_node ns = append_entry(tagfile, "compound", "namespace", "std", "filename", "cpp/std");
+        append_entry(ns, "member", "function", "sort", "anchorfile", "cpp/sort");
+
+        xcpp::xtagfile_index index;
+        index.add(doc, "https://docs/");
+        REQUIRE(index.find("class", "std::vector") == "https://docs/cpp/vector");
+        REQUIRE(index.find("function", "sort") == "https://docs/cpp/sort");
+        REQUIRE(index.find_member("std::vector", "function", "push_back") == "https://docs/cpp/vector/push_back");
+        REQUIRE(index.find_member("std", "function", "sort").empty());
+        REQUIRE(index.find("struct", "std::vector").empty());
+
+        // Entries of the tagfiles added later take precedence.
+        pugi::xml_document other;
+        append_entry(other.append_child("tagfile"), "compound", "class", "std::vector", "filename", "vector.html");
+        index.add(other, "https://other/");
+        REQUIRE(index.find("class", "std::vector") == "https://other/vector.html");
+        REQUIRE(index.find_member("std::vector", "function", "push_back") == "https://docs/cpp/vector/push_back");
+
+        // The compiled index answers the same lookups.
+        std::filesystem::path path = std::filesystem::temp_directory_path() / "xcpp_tagfile_index_test.index";
+        REQUIRE(index.save(path.string()));
+        xcpp::xtagfile_index compiled;
+        REQUIRE(compiled.open(path.string()));
+        REQUIRE(compiled.size() == index.size());
+        REQUIRE(compiled.find("class", "std::vector") == "https://other/vector.html");
+        REQUIRE(compiled.find("function", "sort") == "https://docs/cpp/sort");
+        REQUIRE(compiled.find_member("std::vector", "function", "push_back") == "https://docs/cpp/vector/push_back");
+        REQUIRE(compiled.find("class", "std::map").empty());
+        std::filesystem::remove(path);
+
+        REQUIRE_FALSE(compiled.open(path.string()));
+    }
 }
 
 #if !defined(__EMSCRIPTEN__)
+TEST_SUITE("executable")
+{
+    TEST_CASE("generate_source")
+    {
+        std::vector<std::string> args;
+        std::vector<std::string> declarations = {"#include <iostream>", "int counter = 0;"};
+        xcpp::executable exe(args, declarations);
+
+        std::string source = exe.generate_source("int twice(int a) { return 2 * a; }\ncounter = twice(21);");
+
+        std::size_t definition = source.find("int twice(int a)");
+        std::size_t main = source.find("int main(");
+        std::size_t statement = source.find("counter = twice(21);");
+        REQUIRE(source.find("int counter = 0;") < definition);
+        REQUIRE(definition < main);
+        REQUIRE(main < statement);
+    }
+
+    TEST_CASE("build")
+    {
+        std::vector<std::string> args = {"-std=c++17"};
+        std::vector<std::string> declarations = {"#include <cstdio>"};
+        xcpp::executable exe(args, declarations);
+
+        StreamRedirectRAII redirect(std::cout);
+        exe("executable xcpp_test_executable -O1", "std::puts(\"hello\");");
+
+        REQUIRE(redirect.getCaptured().find("Built xcpp_test_executable") != std::string::npos);
+        std::ifstream binary("xcpp_test_executable");
+        REQUIRE(binary.good());
+        binary.close();
+        std::remove("xcpp_test_executable");
+    }
+}
+
+TEST_SUITE("opt")
+{
+    TEST_CASE("jit_pipeline")
+    {
+        std::vector<std::string> args = {"-O2"};
+        std::vector<std::string> declarations;
+        xcpp::xoptimizer optimizer(args, declarations);
+
+        REQUIRE_FALSE(optimizer.active());
+        REQUIRE(optimizer.jit_pipeline().find("-O2") != std::string::npos);
+    }
+
+    TEST_CASE("cell")
+    {
+        std::vector<const char*> Args = {/*"-v", "resource-dir", "....."*/};
+        xcpp::interpreter interpreter((int)Args.size(), Args.data());
+        std::vector<std::string> args;
+        std::vector<std::string> declarations = {"#include <cstdio>"};
+        xcpp::xoptimizer optimizer(args, declarations);
+        xcpp::opt o(optimizer, declarations);
+
+        StreamRedirectRAII redirect(std::cout);
+        o("opt -O2", "int opt_square(int a) { return a * a; }\nstd::printf(\"%d\\n\", opt_square(7));");
+
+        std::string output = redirect.getCaptured();
+        REQUIRE(output.find("49") != std::string::npos);
+        REQUIRE(output.find("[opt]") != std::string::npos);
+        REQUIRE(output.find("-O2") != std::string::npos);
+    }
+
+#if !defined(_WIN32) && !defined(__EMSCRIPTEN__)
+    TEST_CASE("cell_cache_after_magic")
+    {
+        std::filesystem::path dir = std::filesystem::temp_directory_path() / "xcpp_opt_cell_cache_test";
+        std::filesystem::remove_all(dir);
+        setenv("XCPP_CACHE_DIR", dir.c_str(), 1);
+        setenv("XCPP_CELL_CACHE_SIZE", "1", 1);
+        std::vector<const char*> Args = {/*"-v", "resource-dir", "....."*/};
+        xcpp::interpreter interpreter((int)Args.size(), Args.data());
+        unsetenv("XCPP_CACHE_DIR");
+        unsetenv("XCPP_CELL_CACHE_SIZE");
+
+        auto execute = [&interpreter](const std::string& code)
+        {
+            nl::json user_expressions = nl::json::object();
+            xeus::execute_request_config config;
+            config.silent = false;
+            config.store_history = false;
+            config.allow_stdin = false;
+            nl::json header = nl::json::object();
+            xeus::xrequest_context::guid_list id = {};
+            xeus::xrequest_context context(header, id);
+
+            std::promise<nl::json> promise;
+            std::future<nl::json> future = promise.get_future();
+            auto callback = [&promise](nl::json result) {
+                promise.set_value(result);
+            };
+            interpreter.execute_request(
+                std::move(context),
+                std::move(callback),
+                code,
+                std::move(config),
+                user_expressions
+            );
+            return future.get();
+        };
+
+        // The failure of the first cell must not be replayed once the
+        // magic declared the missing function.
+        const std::string cell = "int cached_cube = opt_cube(3);";
+        REQUIRE(execute(cell)["status"] == "error");
+        REQUIRE(execute("%%opt -O2\nint opt_cube(int a) { return a * a * a; }")["status"] == "ok");
+        REQUIRE(execute(cell)["status"] == "ok");
+
+        std::filesystem::remove_all(dir);
+    }
+#endif
+
+    TEST_CASE("private_directory")
+    {
+        std::string first = xcpp::make_private_directory("xcpp_test_");
+        std::string second = xcpp::make_private_directory("xcpp_test_");
+
+        REQUIRE_FALSE(first.empty());
+        REQUIRE(first != second);
+        REQUIRE(std::filesystem::is_directory(first));
+#if !defined(_WIN32)
+        REQUIRE(std::filesystem::status(first).permissions() == std::filesystem::perms::owner_all);
+#endif
+        std::filesystem::remove_all(first);
+        std::filesystem::remove_all(second);
+    }
+}
+
 TEST_SUITE("xassist"){
 
     TEST_CASE("model_not_found"){
@@ -1216,6 +2281,31 @@ TEST_SUITE("file") {
     }
 }
 
+namespace
+{
+    // Has data() and size() like a range, but is printed with its shape.
+    struct column_major_matrix
+    {
+        const double* data() const
+        {
+            return values;
+        }
+
+        std::size_t size() const
+        {
+            return 4;
+        }
+
+        double values[4] = {1., 2., 3., 4.};
+    };
+
+    std::ostream& operator<<(std::ostream& out, const column_major_matrix& m)
+    {
+        return out << "[[" << m.values[0] << ", " << m.values[2] << "], [" << m.values[1] << ", " << m.values[3]
+                   << "]]";
+    }
+}
+
 TEST_SUITE("mime_bundle_repr")
 {
     TEST_CASE("int")
@@ -1228,6 +2318,292 @@ TEST_SUITE("mime_bundle_repr")
 
         REQUIRE(res == expected);
     }
+
+    TEST_CASE("numeric_range")
+    {
+        std::vector<double> values = {1., 2.5, -0.1};
+        nl::json res = xcpp::mime_bundle_repr(values);
+
+        REQUIRE(res["text/plain"] == "{ 1, 2.5, -0.1 }");
+        REQUIRE(res["text/html"] == "<table>\n<tr><th></th><th>value</th></tr>\n"
+                                    "<tr><th>0</th><td>1</td></tr>\n"
+                                    "<tr><th>1</th><td>2.5</td></tr>\n"
+                                    "<tr><th>2</th><td>-0.1</td></tr>\n</table>");
+
+        int single[] = {7};
+        REQUIRE(xcpp::mime_bundle_repr(std::vector<int>())["text/plain"] == "{}");
+        REQUIRE(xcpp::mime_bundle_repr(single)["text/plain"] == "{ 7 }");
+        REQUIRE(xcpp::mime_bundle_repr(std::string("abc"))["text/plain"] == "abc");
+    }
+
+    TEST_CASE("range_with_printer")
+    {
+        REQUIRE(xcpp::mime_bundle_repr(column_major_matrix())["text/plain"] == "[[1, 3], [2, 4]]");
+    }
+
+    TEST_CASE("bool_range")
+    {
+        std::array<bool, 100> values = {};
+        values[1] = true;
+        std::string expected = "{ false, true";
+        for (std::size_t i = 2; i < values.size(); ++i)
+        {
+            expected += ", false";
+        }
+        expected += " }";
+
+        REQUIRE(xcpp::mime_bundle_repr(values)["text/plain"] == expected);
+    }
+
+    TEST_CASE("numeric_range_elided")
+    {
+        xcpp::repr_options saved = xcpp::get_repr_options();
+        std::vector<int> values(2000);
+        std::iota(values.begin(), values.end(), 0);
+
+        nl::json res = xcpp::mime_bundle_repr(values);
+        REQUIRE(res["text/plain"] == "{ 0, 1, 2, ..., 1997, 1998, 1999 }");
+
+        xcpp::get_repr_options().threshold = 5;
+        xcpp::get_repr_options().edge_items = 1;
+        xcpp::get_repr_options().html = false;
+        res = xcpp::mime_bundle_repr(std::vector<int>(values.begin(), values.begin() + 6));
+        xcpp::get_repr_options() = saved;
+
+        REQUIRE(res["text/plain"] == "{ 0, ..., 5 }");
+        REQUIRE_FALSE(res.contains("text/html"));
+    }
+}
+
+TEST_SUITE("image_view")
+{
+    TEST_CASE("checksums")
+    {
+        const std::string check = "123456789";
+        const auto* data = reinterpret_cast<const std::uint8_t*>(check.data());
+        REQUIRE(xcpp::detail::crc32(data, check.size()) == 0xCBF43926u);
+        REQUIRE(xcpp::detail::adler32(data, check.size()) == 0x091E01DEu);
+    }
+
+    TEST_CASE("base64")
+    {
+        const std::string text = "foobar";
+        const auto* data = reinterpret_cast<const std::uint8_t*>(text.data());
+        REQUIRE(xcpp::base64_encode(data, 0) == "");
+        REQUIRE(xcpp::base64_encode(data, 1) == "Zg==");
+        REQUIRE(xcpp::base64_encode(data, 2) == "Zm8=");
+        REQUIRE(xcpp::base64_encode(data, 3) == "Zm9v");
+        REQUIRE(xcpp::base64_encode(data, 6) == "Zm9vYmFy");
+    }
+
+    TEST_CASE("png")
+    {
+        std::vector<std::uint8_t> pixels(64 * 32 * 4, 0x7F);
+        xcpp::image_view image{pixels.data(), 64, 32, 4};
+        std::vector<std::uint8_t> png = xcpp::encode_png(image);
+
+        const std::vector<std::uint8_t> signature = {0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n'};
+        REQUIRE(std::equal(signature.begin(), signature.end(), png.begin()));
+        // Width, height, bit depth and color type of the IHDR chunk.
+        REQUIRE(std::string(png.begin() + 12, png.begin() + 16) == "IHDR");
+        REQUIRE(png[19] == 64);
+        REQUIRE(png[23] == 32);
+        REQUIRE(png[24] == 8);
+        REQUIRE(png[25] == 6);
+        // Uniform pixels compress to a fraction of their size.
+        REQUIRE(png.size() < pixels.size() / 10);
+        const std::vector<std::uint8_t> end = {'I', 'E', 'N', 'D', 0xAE, 0x42, 0x60, 0x82};
+        REQUIRE(std::equal(end.begin(), end.end(), png.end() - 8));
+
+        nl::json bundle = xcpp::mime_bundle_repr(image);
+        REQUIRE(bundle["text/plain"] == "<image 64x32x4>");
+        REQUIRE(bundle["image/png"] == xcpp::base64_encode(png.data(), png.size()));
+    }
+
+    TEST_CASE("downscale")
+    {
+        std::vector<std::uint8_t> pixels(5 * 4);
+        std::iota(pixels.begin(), pixels.end(), 0);
+        xcpp::image_view image{pixels.data(), 5, 4, 1};
+        image.max_width = 2;
+
+        REQUIRE(xcpp::detail::downscale_factor(image) == 3);
+        std::vector<std::uint8_t> res = xcpp::detail::downscale(image, 3);
+        // 2x2 pixels, the last column and row average the remaining ones.
+        REQUIRE(res == std::vector<std::uint8_t>{6, 9, 16, 19});
+    }
+}
+
+TEST_SUITE("throttled_display")
+{
+    TEST_CASE("keeps_last_value")
+    {
+        std::vector<std::pair<int, bool>> published;
+        std::mutex mutex;
+        {
+            xcpp::throttled_display<int> display(
+                100.,
+                [&](const int& value, bool first)
+                {
+                    std::lock_guard<std::mutex> lock(mutex);
+                    published.emplace_back(value, first);
+                }
+            );
+            std::thread writer(
+                [&display]
+                {
+                    for (int i = 1; i <= 10000; ++i)
+                    {
+                        display.update(i);
+                    }
+                }
+            );
+            writer.join();
+        }
+
+        REQUIRE(!published.empty());
+        REQUIRE(published.size() < 10000);
+        REQUIRE(published.front().second);
+        // The first value published may already be the last one.
+        REQUIRE(published.back().first == 10000);
+        for (std::size_t i = 1; i < published.size(); ++i)
+        {
+            REQUIRE(published[i - 1].first < published[i].first);
+        }
+    }
+
+    TEST_CASE("flush")
+    {
+        std::vector<int> published;
+        std::mutex mutex;
+        xcpp::throttled_display<int> display(
+            0.001,
+            [&](const int& value, bool)
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                published.push_back(value);
+            }
+        );
+        display.update(1);
+        display.flush();
+        display.update(2);
+        display.flush();
+
+        REQUIRE(display.published() == 2);
+        std::lock_guard<std::mutex> lock(mutex);
+        REQUIRE(published == std::vector<int>{1, 2});
+    }
+
+    TEST_CASE("finished_with_the_cell")
+    {
+        std::vector<int> published;
+        std::mutex mutex;
+        xcpp::throttled_display<int> display(
+            0.001,
+            [&](const int& value, bool)
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                published.push_back(value);
+            }
+        );
+        xcpp::begin_cell_output([]() {});
+        display.update(1);
+        display.flush();
+        // Held back by the rate until the end of the cell.
+        display.update(2);
+        xcpp::end_cell_output();
+
+        std::lock_guard<std::mutex> lock(mutex);
+        REQUIRE(published == std::vector<int>{1, 2});
+    }
+
+    TEST_CASE("abandoned")
+    {
+        // As in the frames of an interrupted cell, which are reused without
+        // running the destructor.
+        std::vector<int> published;
+        std::mutex mutex;
+        alignas(xcpp::throttled_display<int>) unsigned char frame[sizeof(xcpp::throttled_display<int>)];
+        auto* display = new (frame) xcpp::throttled_display<int>(
+            0.001,
+            [&](const int& value, bool)
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                published.push_back(value);
+            }
+        );
+        xcpp::begin_cell_output([]() {});
+        display->update(1);
+        std::memset(frame, 0xff, sizeof(frame));
+        xcpp::end_cell_output();
+
+        xcpp::begin_cell_output([]() {});
+        xcpp::end_cell_output();
+
+        std::lock_guard<std::mutex> lock(mutex);
+        REQUIRE(published == std::vector<int>{1});
+    }
+
+    TEST_CASE("reports_errors_once")
+    {
+        StreamRedirectRAII redirect(std::cerr);
+        xcpp::throttled_display<int> display(
+            0.001,
+            [](const int& value, bool)
+            {
+                if (value != 3)
+                {
+                    throw std::runtime_error("cannot render " + std::to_string(value));
+                }
+            }
+        );
+        for (int i = 1; i <= 3; ++i)
+        {
+            display.update(i);
+            display.flush();
+        }
+
+        // The failures are counted, and the display keeps publishing.
+        REQUIRE(display.published() == 3);
+        const std::string err = redirect.getCaptured();
+        REQUIRE(err == "throttled_display: failed to publish a value: cannot render 1\n");
+    }
+}
+
+TEST_SUITE("binary_repr")
+{
+    TEST_CASE("dtype")
+    {
+        REQUIRE(xcpp::dtype<double>() == "<f8");
+        REQUIRE(xcpp::dtype<float>() == "<f4");
+        REQUIRE(xcpp::dtype<std::int32_t>() == "<i4");
+        REQUIRE(xcpp::dtype<std::uint16_t>() == "<u2");
+        REQUIRE(xcpp::dtype<std::int8_t>() == "|i1");
+        REQUIRE(xcpp::dtype<bool>() == "|b1");
+    }
+
+    TEST_CASE("buffer")
+    {
+        std::vector<double> values = {1., 2.5, -3., 4., 5., 6.};
+        xcpp::binary_bundle res = xcpp::binary_repr(values.data(), {2, 3});
+
+        REQUIRE(res.data["dtype"] == "<f8");
+        REQUIRE(res.data["shape"] == nl::json::array({2, 3}));
+        REQUIRE(res.data["nbytes"] == 48);
+        REQUIRE(res.buffers.size() == 1);
+        REQUIRE(res.buffers[0].size() == 48);
+        REQUIRE(std::memcmp(res.buffers[0].data(), values.data(), 48) == 0);
+        REQUIRE(xcpp::binary_summary<double>(res.data) == "<array of float64, shape (2, 3)>");
+    }
+
+    TEST_CASE("empty")
+    {
+        xcpp::binary_bundle res = xcpp::binary_repr<int>(nullptr, {0});
+
+        REQUIRE(res.data["nbytes"] == 0);
+        REQUIRE(res.buffers[0].empty());
+        REQUIRE(xcpp::binary_summary<int>(res.data) == "<array of int32, shape (0,)>");
+    }
 }
 
 #if !defined(__EMSCRIPTEN__)
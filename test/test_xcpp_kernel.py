@@ -6,12 +6,17 @@
 # The full license is in the file LICENSE, distributed with this software.
 #############################################################################
 
+import os
 import unittest
 import jupyter_kernel_test
 import platform
 import nbformat
 import papermill as pm
 
+# The kernels started by the tests inherit the environment. Completions are
+# compared with Clang's, they must not be cut short by the time budget.
+os.environ["XCPP_COMPLETION_TIMEOUT"] = "0"
+
 class BaseXCppCompleteTests(jupyter_kernel_test.KernelTests):
     __test__ = False
     